@@ -0,0 +1,134 @@
+#include "anim_clip.h"
+#include "clip_codec.h"
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <maths/quaternion.h>
+#include <maths/vector4.h>
+#include <map>
+
+AnimClip::AnimClip(gef::Animation* animation) :
+	animation_(animation),
+	info_(NULL),
+	channels_(NULL),
+	channel_count_(0),
+	tracks_(NULL),
+	blocks_(NULL),
+	block_count_(0),
+	keys_(NULL),
+	resolved_skeleton_(NULL),
+	duration_(animation ? animation->duration() : 0.0f),
+	start_time_(animation ? animation->start_time() : 0.0f)
+{
+}
+
+AnimClip::AnimClip() :
+	animation_(NULL),
+	info_(NULL),
+	channels_(NULL),
+	channel_count_(0),
+	tracks_(NULL),
+	blocks_(NULL),
+	block_count_(0),
+	keys_(NULL),
+	resolved_skeleton_(NULL),
+	duration_(0.0f),
+	start_time_(0.0f)
+{
+}
+
+AnimClip::~AnimClip()
+{
+	delete animation_;
+	animation_ = NULL;
+}
+
+bool AnimClip::LoadCooked(const char* blob_filename)
+{
+	if (!blob_.Load(blob_filename) || blob_.type() != BLOB_CLIP)
+		return false;
+
+	info_ = static_cast<const ClipInfo*>(blob_.FindSection(SECTION_CLIP_INFO));
+	if (!info_)
+		return false;
+
+	duration_ = info_->duration;
+	start_time_ = info_->start_time;
+	channels_ = static_cast<const ChannelDesc*>(blob_.FindSection(SECTION_CHANNELS, &channel_count_));
+	tracks_ = static_cast<const TrackDesc*>(blob_.FindSection(SECTION_TRACKS));
+	blocks_ = static_cast<const UInt32*>(blob_.FindSection(SECTION_BLOCKS, &block_count_));
+	keys_ = static_cast<const UInt16*>(blob_.FindSection(SECTION_KEYS));
+
+	// a clip where every track is constant has no keys or blocks
+	if (!channels_ || !tracks_ || (info_->keyed_track_count > 0 && (!blocks_ || !keys_)))
+		channel_count_ = 0;
+
+	return true;
+}
+
+size_t AnimClip::memory_size() const
+{
+	if (!animation_)
+		return blob_.size();
+
+	size_t size = sizeof(gef::Animation);
+	for (std::map<gef::StringId, gef::AnimNode*>::const_iterator node_iter = animation_->anim_nodes().begin(); node_iter != animation_->anim_nodes().end(); ++node_iter)
+	{
+		const gef::TransformAnimNode* node = static_cast<const gef::TransformAnimNode*>(node_iter->second);
+		size += sizeof(gef::TransformAnimNode);
+		size += node->rotation_keys().size() * sizeof(gef::QuaternionKey);
+		size += node->translation_keys().size() * sizeof(gef::Vector3Key);
+		size += node->scale_keys().size() * sizeof(gef::Vector3Key);
+	}
+	return size;
+}
+
+void AnimClip::ResolveJoints(const gef::Skeleton* skeleton) const
+{
+	joint_indices_.resize(channel_count_);
+	for (UInt32 channel_num = 0; channel_num < channel_count_; ++channel_num)
+	{
+		joint_indices_[channel_num] = skeleton->FindJointIndex(channels_[channel_num].joint_name_id);
+	}
+	resolved_skeleton_ = skeleton;
+}
+
+void AnimClip::Sample(gef::SkeletonPose& pose, const gef::SkeletonPose& bind_pose, float time) const
+{
+	if (animation_)
+	{
+		pose.SetPoseFromAnim(*animation_, bind_pose, time);
+		return;
+	}
+
+	// start from the bind pose so joints without a channel are left there
+	pose = bind_pose;
+
+	if (resolved_skeleton_ != bind_pose.skeleton())
+		ResolveJoints(bind_pose.skeleton());
+
+	// decode the keys either side of the time, reading each track from the block in order
+	ClipDecoder decoder(*info_, tracks_, blocks_, block_count_, keys_);
+	decoder.Seek(time);
+
+	std::vector<gef::JointPose>& local_pose = pose.local_pose();
+	for (UInt32 channel_num = 0; channel_num < channel_count_; ++channel_num)
+	{
+		Int32 joint_num = joint_indices_[channel_num];
+		if (joint_num < 0)
+			continue;
+
+		const ChannelDesc& channel = channels_[channel_num];
+		gef::JointPose& joint_pose = local_pose[joint_num];
+
+		if (channel.rotation_track != kNoTrack)
+			joint_pose.set_rotation(decoder.ReadRotation(channel.rotation_track));
+
+		if (channel.translation_track != kNoTrack)
+			joint_pose.set_translation(decoder.ReadVector(channel.translation_track));
+
+		if (channel.scale_track != kNoTrack)
+			joint_pose.set_scale(decoder.ReadVector(channel.scale_track));
+	}
+
+	pose.CalculateGlobalPose();
+}
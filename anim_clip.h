@@ -0,0 +1,67 @@
+#ifndef _ANIM_CLIP_H
+#define _ANIM_CLIP_H
+
+#include "asset_blob.h"
+#include <vector>
+
+namespace gef
+{
+	class Animation;
+	class Skeleton;
+	class SkeletonPose;
+}
+
+// An animation clip that can be sampled into a pose.
+// Wraps either a gef::Animation parsed from a scene file, or a cooked clip blob whose compressed keys are decoded in place.
+class AnimClip
+{
+public:
+	/// @brief Create a clip from a parsed animation. The clip takes ownership of the animation.
+	AnimClip(gef::Animation* animation);
+
+	/// @brief Create an empty clip, to be filled by LoadCooked.
+	AnimClip();
+	~AnimClip();
+
+	/// @brief Load a cooked clip blob.
+	/// @return true if the blob was loaded.
+	bool LoadCooked(const char* blob_filename);
+
+	/// @brief Sample the clip into a pose. Joints without animation data are set to the bind pose.
+	/// @param[out] pose		The pose to write to.
+	/// @param[in] bind_pose	The bind pose for the skeleton being animated.
+	/// @param[in] time			The time to sample the clip at, including the start time.
+	void Sample(gef::SkeletonPose& pose, const gef::SkeletonPose& bind_pose, float time) const;
+
+	float duration() const { return duration_; }
+	float start_time() const { return start_time_; }
+
+	/// @brief The memory held by the clip's key data.
+	size_t memory_size() const;
+
+private:
+	// Work out which skeleton joint each channel drives. Cached as every actor sharing a clip shares a skeleton.
+	void ResolveJoints(const gef::Skeleton* skeleton) const;
+
+	// Set when the clip was parsed from a scene file.
+	gef::Animation* animation_;
+
+	// Set when the clip was cooked. The sections point into the blob.
+	AssetBlob blob_;
+	const ClipInfo* info_;
+	const ChannelDesc* channels_;
+	UInt32 channel_count_;
+	const TrackDesc* tracks_;
+	const UInt32* blocks_;
+	UInt32 block_count_;
+	const UInt16* keys_;
+
+	// The joint index for each channel, for the skeleton they were last resolved against.
+	mutable std::vector<Int32> joint_indices_;
+	mutable const gef::Skeleton* resolved_skeleton_;
+
+	float duration_;
+	float start_time_;
+};
+
+#endif // _ANIM_CLIP_H
@@ -0,0 +1,119 @@
+#include "asset_blob.h"
+#include <system/file.h>
+#include <cstring>
+#include <cstdio>
+
+AssetBlob::AssetBlob() :
+	data_(NULL),
+	size_(0)
+{
+}
+
+AssetBlob::~AssetBlob()
+{
+	Unload();
+}
+
+bool AssetBlob::Load(const char* filename)
+{
+	Unload();
+
+	gef::File* file = gef::File::Create();
+	if (!file->Open(filename))
+	{
+		delete file;
+		return false;
+	}
+
+	// read the whole file in one go, every section is then used in place without any further parsing
+	Int32 file_size = 0;
+	Int32 bytes_read = 0;
+	bool success = file->GetSize(file_size) && file_size >= (Int32)sizeof(AssetBlobHeader);
+	if (success)
+	{
+		data_ = new UInt8[file_size];
+		size_ = file_size;
+		success = file->Read(data_, file_size, bytes_read) && bytes_read == file_size;
+	}
+	file->Close();
+	delete file;
+
+	// check the header matches the format this code was built for
+	if (success)
+	{
+		success = header()->magic == kAssetBlobMagic && header()->version == kAssetBlobVersion &&
+			sizeof(AssetBlobHeader) + header()->section_count * sizeof(AssetBlobSection) <= size_;
+	}
+
+	if (!success)
+		Unload();
+
+	return success;
+}
+
+void AssetBlob::Unload()
+{
+	delete[] data_;
+	data_ = NULL;
+	size_ = 0;
+}
+
+const void* AssetBlob::FindSection(ASSET_BLOB_SECTION id, UInt32* count) const
+{
+	if (!data_)
+		return NULL;
+
+	const AssetBlobSection* sections = reinterpret_cast<const AssetBlobSection*>(data_ + sizeof(AssetBlobHeader));
+	for (UInt32 section_num = 0; section_num < header()->section_count; ++section_num)
+	{
+		const AssetBlobSection& section = sections[section_num];
+		if (section.id == (UInt32)id && section.offset + section.size <= size_)
+		{
+			if (count)
+				*count = section.count;
+			return data_ + section.offset;
+		}
+	}
+
+	return NULL;
+}
+
+void AssetBlob::CookedFilename(const char* source_filename, ASSET_BLOB_TYPE type, char* cooked_filename, int size)
+{
+	// strip the source extension
+	int length = (int)strlen(source_filename);
+	const char* extension = strrchr(source_filename, '.');
+	if (extension)
+		length = (int)(extension - source_filename);
+
+	const char* cooked_extension = "";
+	switch (type)
+	{
+	case BLOB_TEXTURE:
+		cooked_extension = ".texb";
+		break;
+	case BLOB_SCENE:
+		cooked_extension = ".scnb";
+		break;
+	case BLOB_CLIP:
+		cooked_extension = ".anmb";
+		break;
+	}
+
+	snprintf(cooked_filename, size, "%.*s%s", length, source_filename, cooked_extension);
+}
+
+UInt32 AssetBlob::FileSize(const char* filename)
+{
+	gef::File* file = gef::File::Create();
+	Int32 file_size = 0;
+	if (file->Open(filename))
+	{
+		if (!file->GetSize(file_size))
+			file_size = 0;
+		file->Close();
+	}
+	delete file;
+
+	return file_size > 0 ? (UInt32)file_size : 0;
+}
@@ -0,0 +1,168 @@
+#ifndef _ASSET_BLOB_H
+#define _ASSET_BLOB_H
+
+#include <gef.h>
+
+// Identifies a cooked blob file, "GBLB" when read as bytes.
+static const UInt32 kAssetBlobMagic = 0x424c4247;
+static const UInt32 kAssetBlobVersion = 2;
+
+// The kind of asset held in a blob.
+enum ASSET_BLOB_TYPE
+{
+	BLOB_TEXTURE,
+	BLOB_SCENE,
+	BLOB_CLIP
+};
+
+// The sections a blob can contain. Each blob type uses a subset of these.
+enum ASSET_BLOB_SECTION
+{
+	SECTION_TEXTURE_INFO,
+	SECTION_TEXELS,
+	SECTION_MESH_INFO,
+	SECTION_VERTICES,
+	SECTION_PRIMITIVES,
+	SECTION_INDICES,
+	SECTION_MATERIALS,
+	SECTION_JOINTS,
+	SECTION_CLIP_INFO,
+	SECTION_CHANNELS,
+	SECTION_KEYS,
+	SECTION_TRACKS,
+	SECTION_BLOCKS
+};
+
+// The header at the very start of every blob, followed by section_count section entries.
+struct AssetBlobHeader
+{
+	UInt32 magic;
+	UInt32 version;
+	UInt32 type;
+	UInt32 section_count;
+};
+
+// Where a section lives, as a byte offset from the start of the blob.
+struct AssetBlobSection
+{
+	UInt32 id;
+	UInt32 offset;
+	UInt32 size;
+	UInt32 count;
+};
+
+// Section layouts. Everything is plain data so it can be used in place once the file is read.
+struct TextureInfo
+{
+	UInt32 width;
+	UInt32 height;
+};
+
+struct MeshInfo
+{
+	UInt32 num_vertices;
+	UInt32 vertex_byte_size;
+	float aabb_min[3];
+	float aabb_max[3];
+};
+
+struct PrimitiveDesc
+{
+	UInt32 type;
+	UInt32 index_offset;
+	UInt32 num_indices;
+	UInt32 index_byte_size;
+	Int32 material_index;
+};
+
+struct MaterialDesc
+{
+	UInt32 colour;
+	char diffuse_texture[60];
+};
+
+struct JointDesc
+{
+	UInt32 name_id;
+	Int32 parent;
+	float inv_bind_pose[16];
+};
+
+// Clips are compressed: keys that can be rebuilt by interpolating their neighbours are removed, and what is left is
+// quantised to 16 bits. The keys are split into blocks of block_duration seconds, and each block holds every key
+// needed to sample inside it, so sampling only reads one small, contiguous block. See clip_codec.h.
+struct ClipInfo
+{
+	float duration;
+	float start_time;
+	float block_duration;
+	UInt32 keyed_track_count;
+};
+
+// One animated joint. Each track is an index into the tracks section, or kNoTrack if the joint's rotation,
+// translation or scale isn't animated.
+struct ChannelDesc
+{
+	UInt32 joint_name_id;
+	UInt16 rotation_track;
+	UInt16 translation_track;
+	UInt16 scale_track;
+	UInt16 padding;
+};
+
+// How to rebuild one track's values.
+// Constant tracks have no keys, their value is base, which is a quaternion for rotations.
+// Keyed tracks have keys in every block, in order of block_track. Translations and scales are base + key * step on
+// each axis, rotations store their three smallest components.
+struct TrackDesc
+{
+	float base[4];
+	float step[3];
+	UInt32 block_track;
+};
+
+class AssetBlob
+{
+public:
+	AssetBlob();
+	~AssetBlob();
+
+	/// @brief Read a whole blob into memory with a single read, through gef's file system like the other loaders.
+	/// @return true if the file exists and has a valid header.
+	/// @param[in] filename		The cooked file to load.
+	bool Load(const char* filename);
+
+	/// @brief Free the blob's memory.
+	void Unload();
+
+	/// @brief Find a section in the blob.
+	/// @return Pointer to the section data in place, or NULL if the blob doesn't contain it.
+	/// @param[in] id			The section to find.
+	/// @param[out] count		The number of elements in the section. Optional.
+	const void* FindSection(ASSET_BLOB_SECTION id, UInt32* count = NULL) const;
+
+	ASSET_BLOB_TYPE type() const { return (ASSET_BLOB_TYPE)header()->type; }
+	bool loaded() const { return data_ != NULL; }
+	UInt32 size() const { return size_; }
+
+	/// @brief Build the cooked filename for a source asset, e.g. "textures/floor.png" becomes "textures/floor.texb".
+	/// @param[in] source_filename	The source asset's filename.
+	/// @param[in] type				The type of blob it gets cooked to.
+	/// @param[out] cooked_filename	Buffer to write the filename to.
+	/// @param[in] size				Size of the buffer.
+	static void CookedFilename(const char* source_filename, ASSET_BLOB_TYPE type, char* cooked_filename, int size);
+
+	/// @brief Get the size of a file without reading it.
+	/// @return The size in bytes, or 0 if the file doesn't exist.
+	/// @note Used to estimate the memory held by assets loaded through gef's own parsers.
+	static UInt32 FileSize(const char* filename);
+
+private:
+	const AssetBlobHeader* header() const { return reinterpret_cast<const AssetBlobHeader*>(data_); }
+
+	// The whole file, sections are read in place from here.
+	UInt8* data_;
+	UInt32 size_;
+};
+
+#endif // _ASSET_BLOB_H
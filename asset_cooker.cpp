@@ -0,0 +1,650 @@
+#include "asset_cooker.h"
+#include "clip_codec.h"
+#include <system/platform.h>
+#include <system/debug_log.h>
+#include <assets/png_loader.h>
+#include <graphics/image_data.h>
+#include <graphics/scene.h>
+#include <graphics/mesh_data.h>
+#include <animation/skeleton.h>
+#include <animation/animation.h>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+
+namespace
+{
+	// Collects sections and writes them out after a header and section table.
+	class BlobWriter
+	{
+	public:
+		BlobWriter(ASSET_BLOB_TYPE type) : type_(type) {}
+
+		void AddSection(ASSET_BLOB_SECTION id, const void* data, UInt32 size, UInt32 count)
+		{
+			Section section;
+			section.id = id;
+			section.count = count;
+			section.data.assign((const UInt8*)data, (const UInt8*)data + size);
+			sections_.push_back(section);
+		}
+
+		// The size of the blob once written.
+		UInt32 size() const
+		{
+			UInt32 offset = sizeof(AssetBlobHeader) + (UInt32)(sizeof(AssetBlobSection) * sections_.size());
+			for (size_t section_num = 0; section_num < sections_.size(); ++section_num)
+				offset = Align(offset) + (UInt32)sections_[section_num].data.size();
+			return offset;
+		}
+
+		bool Write(const char* filename) const
+		{
+			AssetBlobHeader header;
+			header.magic = kAssetBlobMagic;
+			header.version = kAssetBlobVersion;
+			header.type = type_;
+			header.section_count = (UInt32)sections_.size();
+
+			// lay the sections out after the section table, each one starting on a 16 byte boundary so it can be used in place
+			std::vector<AssetBlobSection> table(sections_.size());
+			UInt32 offset = sizeof(AssetBlobHeader) + (UInt32)(sizeof(AssetBlobSection) * sections_.size());
+			for (size_t section_num = 0; section_num < sections_.size(); ++section_num)
+			{
+				offset = Align(offset);
+				table[section_num].id = sections_[section_num].id;
+				table[section_num].offset = offset;
+				table[section_num].size = (UInt32)sections_[section_num].data.size();
+				table[section_num].count = sections_[section_num].count;
+				offset += table[section_num].size;
+			}
+
+			std::vector<UInt8> blob(offset, 0);
+			memcpy(&blob[0], &header, sizeof(header));
+			if (!table.empty())
+				memcpy(&blob[sizeof(header)], &table[0], sizeof(AssetBlobSection) * table.size());
+			for (size_t section_num = 0; section_num < sections_.size(); ++section_num)
+			{
+				if (!sections_[section_num].data.empty())
+					memcpy(&blob[table[section_num].offset], &sections_[section_num].data[0], table[section_num].size);
+			}
+
+			std::ofstream file(filename, std::ios::binary);
+			if (!file)
+				return false;
+			file.write((const char*)&blob[0], blob.size());
+			return file.good();
+		}
+
+	private:
+		struct Section
+		{
+			UInt32 id;
+			UInt32 count;
+			std::vector<UInt8> data;
+		};
+
+		static UInt32 Align(UInt32 offset) { return (offset + 15) & ~15u; }
+
+		ASSET_BLOB_TYPE type_;
+		std::vector<Section> sections_;
+	};
+
+	bool WriteBlob(const BlobWriter& writer, const char* source_filename, ASSET_BLOB_TYPE type)
+	{
+		char cooked_filename[256];
+		AssetBlob::CookedFilename(source_filename, type, cooked_filename, sizeof(cooked_filename));
+
+		bool success = writer.Write(cooked_filename);
+		gef::DebugOut("Cook %s -> %s %s\n", source_filename, cooked_filename, success ? "ok" : "FAILED");
+		return success;
+	}
+
+	// The kinds of track in a clip, each with its own error tolerance.
+	enum TRACK_KIND
+	{
+		TRACK_ROTATION,
+		TRACK_TRANSLATION,
+		TRACK_SCALE,
+		TRACK_KIND_COUNT
+	};
+
+	// How far a removed key can be from the interpolation of the keys either side of it. Rotations are in radians.
+	const float kTrackTolerance[TRACK_KIND_COUNT] = { 0.001f, 0.001f, 0.001f };
+
+	// A key at full precision. Vectors leave the fourth value unused.
+	struct ClipKey
+	{
+		float time;
+		float value[4];
+	};
+
+	// A track being compressed, with the source keys kept to measure the error against.
+	struct ClipTrack
+	{
+		TRACK_KIND kind;
+		std::vector<ClipKey> source_keys;
+		std::vector<ClipKey> reduced_keys;
+		TrackDesc desc;
+	};
+
+	// The distance between two values, the angle between them for rotations.
+	float ClipKeyError(const float* a, const float* b, TRACK_KIND kind)
+	{
+		if (kind == TRACK_ROTATION)
+		{
+			float dot = fabsf(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+			return 2.0f * acosf(dot < 1.0f ? dot : 1.0f);
+		}
+
+		float x = a[0] - b[0];
+		float y = a[1] - b[1];
+		float z = a[2] - b[2];
+		return sqrtf(x * x + y * y + z * z);
+	}
+
+	// Interpolate between two keys the same way the decoder does.
+	void InterpolateClipKeys(const ClipKey& a, const ClipKey& b, TRACK_KIND kind, float time, float* value)
+	{
+		float blend = b.time > a.time ? (time - a.time) / (b.time - a.time) : 0.0f;
+		blend = blend < 0.0f ? 0.0f : (blend > 1.0f ? 1.0f : blend);
+
+		if (kind == TRACK_ROTATION)
+		{
+			gef::Quaternion start(a.value[0], a.value[1], a.value[2], a.value[3]);
+			gef::Quaternion end(b.value[0], b.value[1], b.value[2], b.value[3]);
+			if (start.x * end.x + start.y * end.y + start.z * end.z + start.w * end.w < 0.0f)
+				end = gef::Quaternion(-end.x, -end.y, -end.z, -end.w);
+
+			gef::Quaternion rotation;
+			rotation.Slerp(start, end, blend);
+			value[0] = rotation.x;
+			value[1] = rotation.y;
+			value[2] = rotation.z;
+			value[3] = rotation.w;
+			return;
+		}
+
+		for (int axis = 0; axis < 4; ++axis)
+			value[axis] = a.value[axis] + (b.value[axis] - a.value[axis]) * blend;
+	}
+
+	// Sample a track's keys at a time.
+	void SampleClipKeys(const std::vector<ClipKey>& keys, TRACK_KIND kind, float time, float* value)
+	{
+		size_t key = 0;
+		while (key + 1 < keys.size() && keys[key + 1].time <= time)
+			++key;
+		size_t next_key = key + 1 < keys.size() ? key + 1 : key;
+		InterpolateClipKeys(keys[key], keys[next_key], kind, time, value);
+	}
+
+	// Remove every key that interpolating between the keys kept either side of it rebuilds within the tolerance.
+	// Keeps extending a span from the last key kept until a key in the middle of it can't be rebuilt.
+	std::vector<ClipKey> ReduceClipKeys(const std::vector<ClipKey>& keys, TRACK_KIND kind)
+	{
+		std::vector<ClipKey> reduced;
+		reduced.push_back(keys[0]);
+
+		size_t anchor = 0;
+		for (size_t end = anchor + 2; end < keys.size(); ++end)
+		{
+			bool fits = true;
+			for (size_t key_num = anchor + 1; key_num < end && fits; ++key_num)
+			{
+				float value[4];
+				InterpolateClipKeys(keys[anchor], keys[end], kind, keys[key_num].time, value);
+				fits = ClipKeyError(value, keys[key_num].value, kind) <= kTrackTolerance[kind];
+			}
+
+			if (!fits)
+			{
+				anchor = end - 1;
+				reduced.push_back(keys[anchor]);
+			}
+		}
+
+		if (keys.size() > 1)
+			reduced.push_back(keys.back());
+
+		return reduced;
+	}
+
+	// Compress a track's keys and add it to the clip's tracks.
+	// Returns the track's index, or kNoTrack if it has no keys.
+	UInt16 AddClipTrack(std::vector<ClipTrack>& tracks, std::vector<ClipKey>& keys, TRACK_KIND kind)
+	{
+		if (keys.empty())
+			return kNoTrack;
+
+		// q and -q are the same rotation, so keep each key on the same side as the last to interpolate the short way
+		if (kind == TRACK_ROTATION)
+		{
+			for (size_t key_num = 1; key_num < keys.size(); ++key_num)
+			{
+				const float* last = keys[key_num - 1].value;
+				float* value = keys[key_num].value;
+				if (last[0] * value[0] + last[1] * value[1] + last[2] * value[2] + last[3] * value[3] < 0.0f)
+				{
+					for (int axis = 0; axis < 4; ++axis)
+						value[axis] = -value[axis];
+				}
+			}
+		}
+
+		ClipTrack track;
+		track.kind = kind;
+		track.source_keys = keys;
+		memset(&track.desc, 0, sizeof(track.desc));
+
+		// a track that never moves further than the tolerance from its first key is stored as that one value
+		bool constant = true;
+		for (size_t key_num = 1; key_num < keys.size() && constant; ++key_num)
+			constant = ClipKeyError(keys[0].value, keys[key_num].value, kind) <= kTrackTolerance[kind];
+
+		if (constant)
+		{
+			memcpy(track.desc.base, keys[0].value, sizeof(track.desc.base));
+			track.desc.block_track = kConstantTrack;
+		}
+		else
+		{
+			track.reduced_keys = ReduceClipKeys(keys, kind);
+			track.desc.block_track = 0;
+
+			// translations and scales are quantised within the range of the track's keys
+			if (kind != TRACK_ROTATION)
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					float min = keys[0].value[axis];
+					float max = min;
+					for (size_t key_num = 1; key_num < keys.size(); ++key_num)
+					{
+						min = keys[key_num].value[axis] < min ? keys[key_num].value[axis] : min;
+						max = keys[key_num].value[axis] > max ? keys[key_num].value[axis] : max;
+					}
+					track.desc.base[axis] = min;
+					track.desc.step[axis] = (max - min) / 65535.0f;
+				}
+			}
+		}
+
+		tracks.push_back(track);
+		return (UInt16)(tracks.size() - 1);
+	}
+
+	// Quantise a key of a keyed track.
+	void QuantiseClipKey(const ClipTrack& track, const ClipKey& key, UInt16* values)
+	{
+		if (track.kind == TRACK_ROTATION)
+		{
+			QuantiseRotation(gef::Quaternion(key.value[0], key.value[1], key.value[2], key.value[3]), values);
+			return;
+		}
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float step = track.desc.step[axis];
+			float steps = step > 0.0f ? floorf((key.value[axis] - track.desc.base[axis]) / step + 0.5f) : 0.0f;
+			values[axis] = (UInt16)(steps < 0.0f ? 0.0f : (steps > 65535.0f ? 65535.0f : steps));
+		}
+	}
+}
+
+bool AssetCooker::CookTexture(const char* png_filename, gef::Platform& platform)
+{
+	gef::PNGLoader png_loader;
+	gef::ImageData image_data;
+	png_loader.Load(png_filename, platform, image_data);
+	if (image_data.image() == NULL)
+		return false;
+
+	TextureInfo info;
+	info.width = image_data.width();
+	info.height = image_data.height();
+
+	// the png loader always decodes to 32 bit RGBA, which is what gets uploaded to the gpu
+	BlobWriter writer(BLOB_TEXTURE);
+	writer.AddSection(SECTION_TEXTURE_INFO, &info, sizeof(info), 1);
+	writer.AddSection(SECTION_TEXELS, image_data.image(), info.width * info.height * 4, info.width * info.height);
+
+	return WriteBlob(writer, png_filename, BLOB_TEXTURE);
+}
+
+bool AssetCooker::CookScene(const char* scene_filename, gef::Platform& platform)
+{
+	gef::Scene scene;
+	if (!scene.ReadSceneFromFile(platform, scene_filename) || scene.mesh_data.empty())
+		return false;
+
+	const gef::MeshData& mesh_data = scene.mesh_data.front();
+
+	MeshInfo mesh_info;
+	mesh_info.num_vertices = mesh_data.vertex_data.num_vertices;
+	mesh_info.vertex_byte_size = mesh_data.vertex_data.vertex_byte_size;
+	mesh_info.aabb_min[0] = mesh_data.aabb.min_vtx().x();
+	mesh_info.aabb_min[1] = mesh_data.aabb.min_vtx().y();
+	mesh_info.aabb_min[2] = mesh_data.aabb.min_vtx().z();
+	mesh_info.aabb_max[0] = mesh_data.aabb.max_vtx().x();
+	mesh_info.aabb_max[1] = mesh_data.aabb.max_vtx().y();
+	mesh_info.aabb_max[2] = mesh_data.aabb.max_vtx().z();
+
+	// materials are referenced by index rather than name so the runtime doesn't need a lookup
+	std::vector<MaterialDesc> materials;
+	std::vector<gef::StringId> material_ids;
+	for (std::list<gef::MaterialData>::const_iterator material_iter = scene.material_data.begin(); material_iter != scene.material_data.end(); ++material_iter)
+	{
+		MaterialDesc material;
+		memset(&material, 0, sizeof(material));
+		material.colour = material_iter->colour;
+		strncpy(material.diffuse_texture, material_iter->diffuse_texture.c_str(), sizeof(material.diffuse_texture) - 1);
+		materials.push_back(material);
+		material_ids.push_back(material_iter->name_id);
+	}
+
+	// every primitive's indices go into one buffer
+	std::vector<PrimitiveDesc> primitives;
+	std::vector<UInt8> indices;
+	for (size_t primitive_num = 0; primitive_num < mesh_data.primitives.size(); ++primitive_num)
+	{
+		const gef::PrimitiveData* primitive_data = mesh_data.primitives[primitive_num];
+
+		PrimitiveDesc primitive;
+		primitive.type = primitive_data->type;
+		primitive.index_offset = (UInt32)indices.size();
+		primitive.num_indices = primitive_data->num_indices;
+		primitive.index_byte_size = primitive_data->index_byte_size;
+		primitive.material_index = -1;
+		for (size_t material_num = 0; material_num < material_ids.size(); ++material_num)
+		{
+			if (material_ids[material_num] == primitive_data->material_name_id)
+				primitive.material_index = (Int32)material_num;
+		}
+		primitives.push_back(primitive);
+
+		const UInt8* index_bytes = (const UInt8*)primitive_data->indices;
+		indices.insert(indices.end(), index_bytes, index_bytes + primitive.num_indices * primitive.index_byte_size);
+	}
+
+	std::vector<JointDesc> joints;
+	if (!scene.skeletons.empty())
+	{
+		const gef::Skeleton* skeleton = scene.skeletons.front();
+		for (int joint_num = 0; joint_num < skeleton->joint_count(); ++joint_num)
+		{
+			const gef::Joint& joint = skeleton->joint(joint_num);
+
+			JointDesc joint_desc;
+			joint_desc.name_id = joint.name_id;
+			joint_desc.parent = joint.parent;
+			memcpy(joint_desc.inv_bind_pose, &joint.inv_bind_pose, sizeof(joint_desc.inv_bind_pose));
+			joints.push_back(joint_desc);
+		}
+	}
+
+	BlobWriter writer(BLOB_SCENE);
+	writer.AddSection(SECTION_MESH_INFO, &mesh_info, sizeof(mesh_info), 1);
+	writer.AddSection(SECTION_VERTICES, mesh_data.vertex_data.vertices, mesh_info.num_vertices * mesh_info.vertex_byte_size, mesh_info.num_vertices);
+	if (!primitives.empty())
+	{
+		writer.AddSection(SECTION_PRIMITIVES, &primitives[0], (UInt32)(primitives.size() * sizeof(PrimitiveDesc)), (UInt32)primitives.size());
+		writer.AddSection(SECTION_INDICES, &indices[0], (UInt32)indices.size(), (UInt32)indices.size());
+	}
+	if (!materials.empty())
+		writer.AddSection(SECTION_MATERIALS, &materials[0], (UInt32)(materials.size() * sizeof(MaterialDesc)), (UInt32)materials.size());
+	if (!joints.empty())
+		writer.AddSection(SECTION_JOINTS, &joints[0], (UInt32)(joints.size() * sizeof(JointDesc)), (UInt32)joints.size());
+
+	return WriteBlob(writer, scene_filename, BLOB_SCENE);
+}
+
+bool AssetCooker::CookClip(const char* anim_scene_filename, gef::Platform& platform)
+{
+	gef::Scene anim_scene;
+	if (!anim_scene.ReadSceneFromFile(platform, anim_scene_filename) || anim_scene.animations.empty())
+		return false;
+
+	// the game only ever uses the first clip in each animation file
+	const gef::Animation* anim = anim_scene.animations.begin()->second;
+
+	ClipInfo clip_info;
+	clip_info.duration = anim->duration();
+	clip_info.start_time = anim->start_time();
+	clip_info.block_duration = kClipBlockDuration;
+
+	// the memory the parsed animation takes up at runtime, to compare against
+	UInt32 source_size = sizeof(gef::Animation);
+	UInt32 source_key_count = 0;
+
+	// compress each joint's tracks, keeping the full precision keys to measure the error against
+	std::vector<ChannelDesc> channels;
+	std::vector<ClipTrack> tracks;
+	for (std::map<gef::StringId, gef::AnimNode*>::const_iterator node_iter = anim->anim_nodes().begin(); node_iter != anim->anim_nodes().end(); ++node_iter)
+	{
+		const gef::TransformAnimNode* node = static_cast<const gef::TransformAnimNode*>(node_iter->second);
+		source_size += sizeof(gef::TransformAnimNode);
+		source_size += (UInt32)(node->rotation_keys().size() * sizeof(gef::QuaternionKey));
+		source_size += (UInt32)(node->translation_keys().size() * sizeof(gef::Vector3Key));
+		source_size += (UInt32)(node->scale_keys().size() * sizeof(gef::Vector3Key));
+		source_key_count += (UInt32)(node->rotation_keys().size() + node->translation_keys().size() + node->scale_keys().size());
+
+		ChannelDesc channel;
+		channel.joint_name_id = node_iter->first;
+		channel.padding = 0;
+
+		std::vector<ClipKey> keys;
+		for (size_t key_num = 0; key_num < node->rotation_keys().size(); ++key_num)
+		{
+			const gef::QuaternionKey& source_key = node->rotation_keys()[key_num];
+			ClipKey key = { source_key.time, { source_key.value.x, source_key.value.y, source_key.value.z, source_key.value.w } };
+			keys.push_back(key);
+		}
+		channel.rotation_track = AddClipTrack(tracks, keys, TRACK_ROTATION);
+
+		keys.clear();
+		for (size_t key_num = 0; key_num < node->translation_keys().size(); ++key_num)
+		{
+			const gef::Vector3Key& source_key = node->translation_keys()[key_num];
+			ClipKey key = { source_key.time, { source_key.value.x(), source_key.value.y(), source_key.value.z(), 0.0f } };
+			keys.push_back(key);
+		}
+		channel.translation_track = AddClipTrack(tracks, keys, TRACK_TRANSLATION);
+
+		keys.clear();
+		for (size_t key_num = 0; key_num < node->scale_keys().size(); ++key_num)
+		{
+			const gef::Vector3Key& source_key = node->scale_keys()[key_num];
+			ClipKey key = { source_key.time, { source_key.value.x(), source_key.value.y(), source_key.value.z(), 0.0f } };
+			keys.push_back(key);
+		}
+		channel.scale_track = AddClipTrack(tracks, keys, TRACK_SCALE);
+
+		channels.push_back(channel);
+	}
+
+	// number the keyed tracks in channel order, the order the decoder reads them in
+	std::vector<TrackDesc> track_descs;
+	std::vector<const ClipTrack*> keyed_tracks;
+	UInt32 reduced_key_count = 0;
+	for (size_t track_num = 0; track_num < tracks.size(); ++track_num)
+	{
+		TrackDesc desc = tracks[track_num].desc;
+		if (desc.block_track != kConstantTrack)
+		{
+			desc.block_track = (UInt32)keyed_tracks.size();
+			keyed_tracks.push_back(&tracks[track_num]);
+			reduced_key_count += (UInt32)tracks[track_num].reduced_keys.size();
+		}
+		else
+		{
+			reduced_key_count++;
+		}
+		track_descs.push_back(desc);
+	}
+	clip_info.keyed_track_count = (UInt32)keyed_tracks.size();
+
+	// write the blocks, each holding every key needed to sample inside it
+	std::vector<UInt32> blocks;
+	std::vector<UInt16> block_keys;
+	if (!keyed_tracks.empty())
+	{
+		UInt32 block_count = (UInt32)ceilf(clip_info.duration / kClipBlockDuration);
+		if (block_count == 0)
+			block_count = 1;
+
+		for (UInt32 block_num = 0; block_num < block_count; ++block_num)
+		{
+			blocks.push_back((UInt32)block_keys.size());
+			float block_start = clip_info.start_time + block_num * kClipBlockDuration;
+			float block_end = block_start + kClipBlockDuration;
+
+			for (size_t track_num = 0; track_num < keyed_tracks.size(); ++track_num)
+			{
+				const ClipTrack& track = *keyed_tracks[track_num];
+				const std::vector<ClipKey>& keys = track.reduced_keys;
+
+				// from the last key at or before the block's start to the first key at or after its end
+				size_t first = 0;
+				while (first + 1 < keys.size() && keys[first + 1].time <= block_start)
+					++first;
+				size_t last = first;
+				while (last + 1 < keys.size() && keys[last].time < block_end)
+					++last;
+
+				block_keys.push_back((UInt16)(last - first + 1));
+				for (size_t key_num = first; key_num <= last; ++key_num)
+					block_keys.push_back(QuantiseClipTime(keys[key_num].time, clip_info.start_time, clip_info.duration));
+				for (size_t key_num = first; key_num <= last; ++key_num)
+				{
+					UInt16 values[3];
+					QuantiseClipKey(track, keys[key_num], values);
+					block_keys.insert(block_keys.end(), values, values + 3);
+				}
+			}
+		}
+	}
+
+	// measure the error by decoding the clip the same way the game does, and comparing it with the source keys
+	float max_error[TRACK_KIND_COUNT] = { 0.0f, 0.0f, 0.0f };
+	ClipDecoder decoder(clip_info, track_descs.empty() ? NULL : &track_descs[0], blocks.empty() ? NULL : &blocks[0], (UInt32)blocks.size(), block_keys.empty() ? NULL : &block_keys[0]);
+	const float sample_step = 1.0f / 120.0f;
+	for (float clip_time = 0.0f; clip_time <= clip_info.duration + sample_step * 0.5f; clip_time += sample_step)
+	{
+		float time = clip_info.start_time + (clip_time < clip_info.duration ? clip_time : clip_info.duration);
+		decoder.Seek(time);
+		for (size_t track_num = 0; track_num < tracks.size(); ++track_num)
+		{
+			const ClipTrack& track = tracks[track_num];
+			float source[4];
+			float decoded[4];
+			SampleClipKeys(track.source_keys, track.kind, time, source);
+			if (track.kind == TRACK_ROTATION)
+			{
+				gef::Quaternion rotation = decoder.ReadRotation((UInt16)track_num);
+				decoded[0] = rotation.x;
+				decoded[1] = rotation.y;
+				decoded[2] = rotation.z;
+				decoded[3] = rotation.w;
+			}
+			else
+			{
+				gef::Vector4 value = decoder.ReadVector((UInt16)track_num);
+				decoded[0] = value.x();
+				decoded[1] = value.y();
+				decoded[2] = value.z();
+				decoded[3] = 0.0f;
+			}
+
+			float error = ClipKeyError(source, decoded, track.kind);
+			if (error > max_error[track.kind])
+				max_error[track.kind] = error;
+		}
+	}
+
+	BlobWriter writer(BLOB_CLIP);
+	writer.AddSection(SECTION_CLIP_INFO, &clip_info, sizeof(clip_info), 1);
+	if (!channels.empty())
+		writer.AddSection(SECTION_CHANNELS, &channels[0], (UInt32)(channels.size() * sizeof(ChannelDesc)), (UInt32)channels.size());
+	if (!track_descs.empty())
+		writer.AddSection(SECTION_TRACKS, &track_descs[0], (UInt32)(track_descs.size() * sizeof(TrackDesc)), (UInt32)track_descs.size());
+	if (!blocks.empty())
+		writer.AddSection(SECTION_BLOCKS, &blocks[0], (UInt32)(blocks.size() * sizeof(UInt32)), (UInt32)blocks.size());
+	if (!block_keys.empty())
+		writer.AddSection(SECTION_KEYS, &block_keys[0], (UInt32)(block_keys.size() * sizeof(UInt16)), (UInt32)block_keys.size());
+
+	gef::DebugOut("Clip %s: %u -> %u bytes (%.1fx smaller), %u -> %u keys, max error %.3f degrees, %.5f translation, %.5f scale\n",
+		anim_scene_filename, source_size, writer.size(), writer.size() > 0 ? (float)source_size / writer.size() : 0.0f,
+		source_key_count, reduced_key_count,
+		max_error[TRACK_ROTATION] * 57.2957795f, max_error[TRACK_TRANSLATION], max_error[TRACK_SCALE]);
+
+	return WriteBlob(writer, anim_scene_filename, BLOB_CLIP);
+}
+
+int AssetCooker::CookAll(gef::Platform& platform)
+{
+	// Every asset loaded by the game. Audio isn't cooked as the audio manager can only load samples from wav files.
+	const char* textures[] =
+	{
+		"textures/splash.png",
+		"textures/background.png",
+		"textures/title.png",
+		"textures/controls.png",
+		"textures/win.png",
+		"textures/lose.png",
+		"textures/floor.png",
+		"textures/crate.png",
+		"textures/jump_crate.png",
+		"textures/metal_crate.png",
+		"textures/jump_metal_crate.png",
+		"textures/metal.png",
+		"textures/wall.png",
+		"textures/wood.png",
+		"textures/coin.png",
+		"textures/sawblade.png",
+		"textures/checkpoint.png",
+		"Ch10_1001_Specular.png",
+		"Ch10_1002_Specular.png",
+		"Ch33_1001_Specular.png"
+	};
+
+	const char* scenes[] =
+	{
+		"player/player.scn",
+		"enemy/zombie.scn"
+	};
+
+	const char* clips[] =
+	{
+		"player/anim-kick.scn",
+		"player/anim-idle.scn",
+		"player/anim-jump.scn",
+		"player/anim-fall.scn",
+		"player/anim-land.scn",
+		"player/anim-run.scn",
+		"player/anim-death.scn",
+		"player/anim-dance.scn",
+		"enemy/anim-zombie-idle.scn",
+		"enemy/anim-zombie-run.scn"
+	};
+
+	int failed = 0;
+	for (int i = 0; i < (int)(sizeof(textures) / sizeof(textures[0])); i++)
+	{
+		if (!CookTexture(textures[i], platform))
+			failed++;
+	}
+	for (int i = 0; i < (int)(sizeof(scenes) / sizeof(scenes[0])); i++)
+	{
+		if (!CookScene(scenes[i], platform))
+			failed++;
+	}
+	for (int i = 0; i < (int)(sizeof(clips) / sizeof(clips[0])); i++)
+	{
+		if (!CookClip(clips[i], platform))
+			failed++;
+	}
+
+	return failed;
+}
@@ -0,0 +1,33 @@
+#ifndef _ASSET_COOKER_H
+#define _ASSET_COOKER_H
+
+#include "asset_blob.h"
+
+namespace gef
+{
+	class Platform;
+}
+
+// Offline tool that converts source assets into blobs that can be used in place by AssetBlob.
+// Built into the game when COOK_ASSETS is defined, so it reads the source files with the same platform file system as the runtime.
+class AssetCooker
+{
+public:
+	/// @brief Decode a PNG and write its raw RGBA texels.
+	/// @return true if the blob was written.
+	static bool CookTexture(const char* png_filename, gef::Platform& platform);
+
+	/// @brief Parse a scene and write its first mesh's vertex and index buffers, materials and first skeleton.
+	/// @return true if the blob was written.
+	static bool CookScene(const char* scene_filename, gef::Platform& platform);
+
+	/// @brief Parse an animation scene and write the first clip compressed, reporting its size and error.
+	/// @return true if the blob was written.
+	static bool CookClip(const char* anim_scene_filename, gef::Platform& platform);
+
+	/// @brief Cook every asset the game loads.
+	/// @return The number of assets that failed to cook.
+	static int CookAll(gef::Platform& platform);
+};
+
+#endif // _ASSET_COOKER_H
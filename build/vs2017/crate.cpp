@@ -1,4 +1,5 @@
 #include "crate.h"
+#include <graphics/mesh.h>
 
 // Constructor
 Crate::Crate()
@@ -7,6 +8,8 @@ Crate::Crate()
 	SetType(CrateType::WOOD);
 	destroyed_ = false;
 	timer_ = 0;
+	debris_ = NULL;
+	debris_floor_y_ = 0.0f;
 }
 
 void Crate::Update(float frame_time)
@@ -17,32 +20,31 @@ void Crate::Update(float frame_time)
 		// Set destroyed boolean to true.
 		destroyed_ = true;
 
-		// For each plank...
-		for (int i = 0; i < plank_count_; i++)
+		// Break the crate into planks and splinters. They're only for show, so they are particles rather than physics bodies.
+		if (debris_)
 		{
-			// Force to be applied to each plank. Each plank flies off in a different direction.
-			b2Vec2 force;
-			switch (i)
-			{
-			case 0:
-				force = b2Vec2(-100, 100);
-				break;
-			case 1:
-				force = b2Vec2(-100, 200);
-				break;
-			case 2:
-				force = b2Vec2(100, 200);
-				break;
-			case 3:
-				force = b2Vec2(100, 100);
-				break;
-			}
-
-			// Enable the plank's physics body, applies the above defined force, and applies torque to make it rotate.
-			planks_[i].GetBody()->SetEnabled(true);
-			planks_[i].GetBody()->ApplyForceToCenter(force, true);
-			planks_[i].GetBody()->ApplyTorque(20, true);
-			
+			ParticleBurst burst;
+			burst.position = gef::Vector4(GetBody()->GetPosition().x, GetBody()->GetPosition().y, 0.0f);
+			burst.position_spread = gef::Vector4(0.3f, 0.3f, 0.3f);
+			burst.velocity_min_x = -10.0f;
+			burst.velocity_max_x = 10.0f;
+			burst.velocity_min_y = 6.0f;
+			burst.velocity_max_y = 18.0f;
+			burst.spin_min = -30.0f;
+			burst.spin_max = 30.0f;
+			burst.lifetime_min = 2.0f;
+			burst.lifetime_max = 3.0f;
+			burst.floor_y = debris_floor_y_;
+
+			// Full size planks.
+			burst.count = plank_count_;
+			debris_->Emit(burst);
+
+			// Smaller splinters.
+			burst.count = splinter_count_;
+			burst.scale_min = 0.2f;
+			burst.scale_max = 0.5f;
+			debris_->Emit(burst);
 		}
 
 		// For each coin...
@@ -98,7 +100,7 @@ void Crate::Update(float frame_time)
 
 }
 
-void Crate::Init(PrimitiveBuilder* primitive_builder, b2World* world)
+void Crate::Init(gef::Mesh* coin_mesh, PhysicsRegions* physics_regions, ParticleSystem* debris, float debris_floor_y)
 {
 	// The crate type determines how many coins are contained within the crate. The crate type should have been defined before calling this function, otherwise it will default to a wooden crate.
 	switch (type_)
@@ -117,46 +119,12 @@ void Crate::Init(PrimitiveBuilder* primitive_builder, b2World* world)
 	// Save the initial type to be used when reseting the crate.
 	initial_type_ = type_;
 
-	// The half dimensions of a plank.
-	gef::Vector4 plank_half_dimensions(0.1f, 0.4f, 0.02f);
-
-	// Create a physics body for the plank. It will be dynamic and its position is the crate's position.
-	b2BodyDef plank_body_def;
-	plank_body_def.type = b2_dynamicBody;
-	plank_body_def.position = b2Vec2(GetBody()->GetPosition().x, GetBody()->GetPosition().y);
-
-	// Create the shape for the plank.
-	b2PolygonShape plank_shape;
-	plank_shape.SetAsBox(plank_half_dimensions.x(), plank_half_dimensions.y());
-
-	// Create the planks fixture.
-	b2FixtureDef plank_fixture_def;
-	plank_fixture_def.shape = &plank_shape;
-	plank_fixture_def.density = 1.0f;
-
-	// Setup each plank.
-	for (int i = 0; i < plank_count_; i++)
-	{
-		// Create a mesh for the plank based on its defined dimensions.
-		planks_[i].set_mesh(primitive_builder->CreateBoxMesh(plank_half_dimensions));
-
-		// Create a connection between the rigid body and plank.
-		plank_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&planks_[i]);
-		planks_[i].SetBody(plank_body_def, world);
-
-		// Create the fixture on the rigid body.
-		planks_[i].GetBody()->CreateFixture(&plank_fixture_def);
-
-		// Disables the body and sets it to a sensor (so it doesn't stop on collision with other objects).
-		planks_[i].GetBody()->SetEnabled(false);
-		planks_[i].GetBody()->GetFixtureList()->SetSensor(true);
-
-		// Update visuals from simulation data.
-		planks_[i].UpdateFromSimulation();
-	}
+	// Set where the crate's debris goes when it is destroyed, and the height of the ground it lands on.
+	debris_ = debris;
+	debris_floor_y_ = debris_floor_y;
 
 	// The half dimensions of a coin.
-	gef::Vector4 coin_half_dimensions(0.3f, 0.3f, 0.0f);
+	gef::Vector4 coin_half_dimensions = GetCoinHalfDimensions();
 
 	// Create a physics body for the coin. It will be dynamic and its position is the crate's position.
 	b2BodyDef coin_body_def;
@@ -175,20 +143,21 @@ void Crate::Init(PrimitiveBuilder* primitive_builder, b2World* world)
 	// Setup each coin.
 	for (int i = 0; i < coin_count_; i++)
 	{
-		// Create a mesh for the coin based on its defined dimensions.
-		coins_[i].set_mesh(primitive_builder->CreateBoxMesh(coin_half_dimensions));
+		// Apply the mesh to the coin.
+		coins_[i].set_mesh(coin_mesh);
 
 		// Create a connection between the rigid body and coin.
 		coin_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&coins_[i]);
-		coins_[i].SetBody(coin_body_def, world);
+		coins_[i].SetBody(coin_body_def, physics_regions->WorldAt(coin_body_def.position.x));
 
 		// Create the fixture on the rigid body.
-		coins_[i].GetBody()->CreateFixture(&coin_fixture_def);
+		coins_[i].CreateFixture(coin_fixture_def);
 
 		// Disables the body, sets it to a sensor and sets fixed rotation to true so that it doesn't rotate.
 		coins_[i].GetBody()->SetEnabled(false);
 		coins_[i].GetBody()->GetFixtureList()->SetSensor(true);
 		coins_[i].GetBody()->SetFixedRotation(true);
+		physics_regions->Add(&coins_[i]);
 
 		// Update visuals from simulation data.
 		coins_[i].UpdateFromSimulation();
@@ -203,16 +172,6 @@ void Crate::Reset()
 	timer_ = 0;
 	GetBody()->GetFixtureList()->SetSensor(false);
 
-	// For each plank...
-	for (int i = 0; i < plank_count_; i++)
-	{
-		// Sets its velocity to 0, reset its position, disable it, then reflect these changes in the box2d simulation.
-		planks_[i].GetBody()->SetLinearVelocity(b2Vec2(0, 0));
-		planks_[i].GetBody()->SetTransform(b2Vec2(GetBody()->GetPosition().x, GetBody()->GetPosition().y), 0);
-		planks_[i].GetBody()->SetEnabled(false);
-		planks_[i].UpdateFromSimulation();
-	}
-
 	// For each coin...
 	for (int i = 0; i < coin_count_; i++)
 	{
@@ -226,23 +185,14 @@ void Crate::Reset()
 	}
 }
 
-void Crate::RenderPlanks(gef::Renderer3D* renderer_3d)
+void Crate::RenderCoins(RenderQueue* render_queue, const gef::Material* material)
 {
-	// Render the destroyed crate's planks.
-	for (int i = 0; i < plank_count_; i++)
-	{
-		renderer_3d->DrawMesh(planks_[i]);
-	}
-}
-
-void Crate::RenderCoins(gef::Renderer3D* renderer_3d)
-{
-	// Render coins released from crate if they have not been collected.
+	// Queue coins released from crate if they have not been collected.
 	for (int i = 0; i < coin_count_; i++)
 	{
 		if (!coins_[i].GetCollected())
 		{
-			renderer_3d->DrawMesh(coins_[i]);
+			render_queue->AddMesh(PASS_ALPHA, material, coins_[i].mesh(), coins_[i].transform());
 		}
 	}
 }
@@ -256,12 +206,6 @@ void Crate::Destroy()
 
 void Crate::UpdateDestroyedSimulation()
 {
-	// Update each plank based on the box2d simulation.
-	for (int i = 0; i < plank_count_; i++)
-	{
-		planks_[i].UpdateFromSimulation();
-	}
-
 	// Update each coin based on the box2d simulation.
 	for (int i = 0; i < coin_count_; i++)
 	{
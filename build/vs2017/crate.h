@@ -4,6 +4,10 @@
 #include "primitive_builder.h"
 #include "box2d/box2d.h"
 #include "coin.h"
+#include "level_arena.h"
+#include "physics_regions.h"
+#include "render_queue.h"
+#include "particle_system.h"
 
 // Different types of crates
 // Wood - destructible, contains 3 coins
@@ -27,18 +31,24 @@ public:
 	Crate();
 
 	// Functions for updating, initialising and reseting the crate.
+	// The coins use the mesh they are given, which the level shares between everything with the coins' dimensions.
 	void Update(float frame_time);
-	void Init(PrimitiveBuilder* primitive_builder, b2World* world);
+	void Init(gef::Mesh* coin_mesh, PhysicsRegions* physics_regions, ParticleSystem* debris, float debris_floor_y);
 	void Reset();
 
-	// Functions to render the planks and coins.
-	void RenderPlanks(gef::Renderer3D* renderer_3d);
-	void RenderCoins(gef::Renderer3D* renderer_3d);
+	// Getter for the half dimensions of the coins inside a crate, so the level can make their mesh.
+	static gef::Vector4 GetCoinHalfDimensions()
+	{
+		return gef::Vector4(0.3f, 0.3f, 0.0f);
+	};
+
+	// Function to queue the released coins for rendering with the given material.
+	void RenderCoins(RenderQueue* render_queue, const gef::Material* material);
 
 	// Function to destroy the crate.
 	void Destroy();
 
-	// To update the physics of the planks and coins after the crate is destroyed.
+	// To update the physics of the coins after the crate is destroyed.
 	void UpdateDestroyedSimulation();
 
 	// Getter and setter for the crate's type.
@@ -62,9 +72,11 @@ private:
 	// Float for holding time passed. Used for a delay in enabling collisions of coins.
 	float timer_;
 
-	// Planks to be released when the crate is destroyed.
-	GameObject planks_[4];
+	// The particle system the crate's planks and splinters are emitted into when it is destroyed, and the height of the ground below the crate.
+	ParticleSystem* debris_;
+	float debris_floor_y_;
 	int plank_count_ = 4;
+	int splinter_count_ = 24;
 
 	// Coins to be released when the crate is destroyed.
 	Coin coins_[3];
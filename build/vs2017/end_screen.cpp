@@ -1,17 +1,22 @@
 #include "end_screen.h"
+#include "level_host.h"
+#include "load_texture.h"
+#include "memory_tracker.h"
 
 // Constructor
 EndScreen::EndScreen()
 {
 	active_touch_id_ = -1; // Not currently processing a touch.
+	win_texture_ = NULL;
+	lose_texture_ = NULL;
+	texture_bytes_ = 0;
 }
 
 void EndScreen::Update(float frame_time)
 {
-	// Update the input manager, then call the functions for processing each kind of input.
+	// Call the functions for processing each kind of input. SceneApp has already updated the input manager this frame.
 	if (input_manager_)
 	{
-		input_manager_->Update();
 		ProcessTouchInput();
 		ProcessKeyboardInput();
 		ProcessControllerInput();
@@ -51,7 +56,7 @@ void EndScreen::Render()
 			0xffffffff,
 			gef::TJ_LEFT,
 			"COINS COLLECTED: %i/100",
-			level_->GetScore());
+			level_host_->GetLevel()->GetScore());
 
 		font_->RenderText(
 			sprite_renderer_,
@@ -60,7 +65,7 @@ void EndScreen::Render()
 			0xffffffff,
 			gef::TJ_LEFT,
 			"TIME: %.1fs",
-			level_->GetTime());
+			level_host_->GetLevel()->GetTime());
 	}
 	else if (game_state_->GetGameState() == State::LOSE) // if the player loses, display 'you lose'.
 	{
@@ -86,7 +91,7 @@ void EndScreen::Render()
 	sprite_renderer_->End();
 }
 
-void EndScreen::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, Level* l, MainMenu* mm)
+void EndScreen::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, LevelHost* lh, MainMenu* mm)
 {
 	// Assign values to all of the pointers.
 	sprite_renderer_ = sr;
@@ -95,26 +100,41 @@ void EndScreen::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, Ga
 	game_state_ = gs;
 	input_manager_ = im;
 	audio_manager_ = am;
-	level_ = l;
+	level_host_ = lh;
 	main_menu_ = mm;
 
 	// Load and asssign the textures for the win and lose background images.
-	gef::ImageData texture_image;
-	gef::PNGLoader png_loader;
-	png_loader.Load("textures/win.png", *platform_, texture_image);
-	gef::Texture* texture = gef::Texture::Create(*platform_, texture_image);
+	// Each texture's size is added up for the memory tracker.
+	UInt32 byte_size = 0;
+	win_texture_ = LoadTexture("textures/win.png", *platform_, &byte_size);
+	texture_bytes_ += byte_size;
 
-	win_image_.set_texture(texture);
+	win_image_.set_texture(win_texture_);
 	win_image_.set_position(platform_->width() / 2, platform_->height() / 2, 0);
 	win_image_.set_width(platform_->width());
 	win_image_.set_height(platform_->height());
 
-	png_loader.Load("textures/lose.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	lose_image_.set_texture(texture);
+	byte_size = 0;
+	lose_texture_ = LoadTexture("textures/lose.png", *platform_, &byte_size);
+	texture_bytes_ += byte_size;
+	lose_image_.set_texture(lose_texture_);
 	lose_image_.set_position(platform_->width() / 2, platform_->height() / 2, 0);
 	lose_image_.set_width(platform_->width());
 	lose_image_.set_height(platform_->height());
+
+	MemoryTracker::Allocated(MEMORY_TEXTURES, texture_bytes_);
+}
+
+void EndScreen::CleanUp()
+{
+	// Free the win and lose textures.
+	delete win_texture_;
+	win_texture_ = NULL;
+	delete lose_texture_;
+	lose_texture_ = NULL;
+
+	MemoryTracker::Freed(MEMORY_TEXTURES, texture_bytes_);
+	texture_bytes_ = 0;
 }
 
 void EndScreen::ProcessTouchInput()
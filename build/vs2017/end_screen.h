@@ -24,7 +24,10 @@ public:
 	// Functions for updating, rendering and initialising.
 	void Update(float frame_time);
 	void Render();
-	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, Level* l, MainMenu* mm);
+	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, LevelHost* lh, MainMenu* mm);
+
+	// Frees the textures loaded by Init.
+	void CleanUp();
 
 private:
 	// Functions for processing input.
@@ -42,13 +45,18 @@ private:
 	gef::InputManager* input_manager_;
 	gef::AudioManager* audio_manager_;
 	GameState* game_state_;
-	Level* level_;
+	LevelHost* level_host_;
 	MainMenu* main_menu_;
 
 	// Background images for the win and lose state.
 	gef::Sprite win_image_;
 	gef::Sprite lose_image_;
 
+	// The textures the sprites use, and their size for the memory tracker.
+	gef::Texture* win_texture_;
+	gef::Texture* lose_texture_;
+	UInt32 texture_bytes_;
+
 	// Store the current touch id.
 	Int32 active_touch_id_;
 };
@@ -15,6 +15,13 @@ Enemy::Enemy()
 	start_position_ = b2Vec2(0.0f, 0.0f);
 	timer_ = 0.0f;
 	speed_ = 4.0f;
+	phase_ = 0.0f;
+	pose_cache_ = NULL;
+	animation_interval_ = 1;
+	bone_matrices_ = NULL;
+	animated_mesh_ = NULL;
+	idle_anim_ = NULL;
+	run_anim_ = NULL;
 }
 
 void Enemy::Update(float frame_time)
@@ -75,7 +82,6 @@ void Enemy::Update(float frame_time)
 			{
 				anim_player_.set_clip(idle_anim_);
 				anim_player_.set_looping(true);
-				anim_player_.set_anim_time(0.0f);
 				anim_player_.set_playback_speed(1.0f);
 			}
 			break;
@@ -84,7 +90,6 @@ void Enemy::Update(float frame_time)
 			{
 				anim_player_.set_clip(run_anim_);
 				anim_player_.set_looping(true);
-				anim_player_.set_anim_time(0.0f);
 				anim_player_.set_playback_speed(1.0f);
 			}
 			break;
@@ -93,7 +98,6 @@ void Enemy::Update(float frame_time)
 			{
 				anim_player_.set_clip(idle_anim_);
 				anim_player_.set_looping(true);
-				anim_player_.set_anim_time(0.0f);
 				anim_player_.set_playback_speed(1.0f);
 			}
 			break;
@@ -108,12 +112,10 @@ void Enemy::Update(float frame_time)
 	// Play the animation and update the mesh's transform.
 	if (animated_mesh_)
 	{
-		// update the pose in the anim player from the animation
-		anim_player_.Update(frame_time, animated_mesh_->bind_pose());
-
-		// update the bone matrices that are used for rendering the character
-		// from the newly updated pose in the anim player
-		animated_mesh_->UpdateBoneMatrices(anim_player_.pose());
+		// play from the pose cache's shared clock rather than from when this enemy last changed clip, so every enemy
+		// in the same phase playing the same clip is at the same time, and the pose is only sampled once for all of them
+		anim_player_.set_anim_time(pose_cache_->LoopTime(anim_player_.clip(), phase_));
+		bone_matrices_ = &pose_cache_->BoneMatrices(anim_player_.clip(), anim_player_.anim_time(), animation_interval_);
 
 		// Apply offset to the body's position.
 		gef::Vector4 position(body_->GetPosition().x + x_offset_, body_->GetPosition().y + y_offset_, 0.0f);
@@ -148,26 +150,23 @@ void Enemy::Update(float frame_time)
 	}
 }
 
-void Enemy::Init(gef::Platform* p, gef::Scene* enemy_scene)
+void Enemy::Init(gef::Platform* p, gef::Mesh* enemy_mesh, gef::Skeleton* skeleton, AnimClip* idle_anim, AnimClip* run_anim, PoseCache* pose_cache, LevelArena* arena)
 {
-	// Set platform pointer.
+	// Set platform and pose cache pointers.
 	platform_ = p;
-
-	// Get the enemy's mesh and skeleton from the scene.
-	gef::Mesh* enemy_mesh = MotionClipPlayer::GetFirstMesh(enemy_scene, platform_);
-	gef::Skeleton* skeleton = MotionClipPlayer::GetFirstSkeleton(enemy_scene);
+	pose_cache_ = pose_cache;
 
 	// Create the animated mesh.
 	if (skeleton)
 	{
-		animated_mesh_ = new gef::SkinnedMeshInstance(*skeleton);
+		animated_mesh_ = arena->New<gef::SkinnedMeshInstance>(MEMORY_ANIMATION, *skeleton);
 		anim_player_.Init(animated_mesh_->bind_pose());
 		animated_mesh_->set_mesh(enemy_mesh);
 	}
 	
-	// Load the animations.
-	idle_anim_ = MotionClipPlayer::LoadAnimation("enemy/anim-zombie-idle.scn", "", platform_);
-	run_anim_ = MotionClipPlayer::LoadAnimation("enemy/anim-zombie-run.scn", "", platform_);
+	// Set the animations.
+	idle_anim_ = idle_anim;
+	run_anim_ = run_anim;
 
 	// Set mesh's initial transform.
 	animated_mesh_->set_transform(this->transform());
@@ -176,12 +175,12 @@ void Enemy::Init(gef::Platform* p, gef::Scene* enemy_scene)
 	start_position_ = GetBody()->GetPosition();
 }
 
-void Enemy::Render(gef::Renderer3D* renderer_3d)
+void Enemy::Render(RenderQueue* render_queue)
 {
-	// Render the animated mesh.
-	if (animated_mesh_) 
+	// Queue the animated mesh with this frame's shared pose. It uses the model's own materials.
+	if (animated_mesh_ && bone_matrices_)
 	{
-		renderer_3d->DrawSkinnedMesh(*animated_mesh_, animated_mesh_->bone_matrices(), true);
+		render_queue->AddSkinnedMesh(PASS_SKINNED, NULL, animated_mesh_->mesh(), animated_mesh_->transform(), *bone_matrices_);
 	}
 }
 
@@ -4,6 +4,9 @@
 #include <animation/animation.h>
 #include <graphics/scene.h>
 #include "motion_clip_player.h"
+#include "pose_cache.h"
+#include "level_arena.h"
+#include "render_queue.h"
 #include "graphics/renderer_3d.h"
 #include "maths/math_utils.h"
 
@@ -30,8 +33,8 @@ public:
 
 	// Functions for updating, initialising, rendering and reseting the enemy.
 	void Update(float frame_time);
-	void Init(gef::Platform* p, gef::Scene* s);
-	void Render(gef::Renderer3D* renderer_3d);
+	void Init(gef::Platform* p, gef::Mesh* mesh, gef::Skeleton* skeleton, AnimClip* idle_anim, AnimClip* run_anim, PoseCache* pose_cache, LevelArena* arena);
+	void Render(RenderQueue* render_queue);
 	void Reset();
 	
 	// Function for setting the enemy as dead. Has a parameter for the direction that the kill came from.
@@ -40,6 +43,20 @@ public:
 	// Sets the distance that the enemy will travel, and the time it will remain idle for before switching directions.
 	void SetPath(float distance, float time);
 
+	// Sets how far ahead of the pose cache's shared clock the enemy's animations play, as a fraction of the animation's length,
+	// so enemies aren't all in step. Enemies with the same phase playing the same animation share one pose.
+	void SetPhase(float phase)
+	{
+		phase_ = phase;
+	};
+
+	// Sets how many pose steps the enemy's animation moves on by at a time. Enemies far from the player animate in
+	// bigger steps when the frame is busy. It only changes how the enemy looks, not how it moves.
+	void SetAnimationInterval(UInt32 interval)
+	{
+		animation_interval_ = interval;
+	};
+
 	// Getter and setters for the enemy's state.
 	EnemyState GetState()
 	{
@@ -94,9 +111,15 @@ private:
 	// The enemy's animated mesh.
 	gef::SkinnedMeshInstance* animated_mesh_;
 
-	// The enemy's animations and animation player.
-	gef::Animation* idle_anim_;
-	gef::Animation* run_anim_;
+	// The enemy's animations and animation player. The animations are shared by every enemy.
+	AnimClip* idle_anim_;
+	AnimClip* run_anim_;
 	MotionClipPlayer anim_player_;
+
+	// The enemy's phase, and the bone matrices for this frame's pose. The poses are shared with every enemy in the same phase.
+	float phase_;
+	PoseCache* pose_cache_;
+	UInt32 animation_interval_;
+	const std::vector<gef::Matrix44>* bone_matrices_;
 };
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 
 // Enum with all of the possible states.
 enum class State {
@@ -19,7 +20,7 @@ public:
 	State GetGameState();
 	void SetGameState(State s);
 private:
-	// Holds the current state
-	State current_state_;
+	// Holds the current state. Atomic as the level sets it from the simulation thread while the renderer reads it.
+	std::atomic<State> current_state_;
 };
 
@@ -1,4 +1,7 @@
 #include "level.h"
+#include "load_texture.h"
+#include <graphics/mesh.h>
+#include <chrono>
 
 Level::Level()
 {
@@ -13,12 +16,50 @@ Level::Level()
 	respawn_position_ = b2Vec2(-8.0f, 3.0f);
 	active_touch_id_ = -1;
 	audio_proximity_ = 15.0f;
+	plank_mesh_ = NULL;
+	spark_mesh_ = NULL;
+	show_physics_stats_ = false;
+	proxy_count_ = 0;
+	pair_count_ = 0;
+	touching_count_ = 0;
+	step_time_ = 0.0f;
+	update_time_ = 0.0f;
+	quality_ = FrameGovernor().settings();
+	quality_tier_ = QUALITY_HIGH;
+	frame_load_ = 0.0f;
+	input_service_ = NULL;
+	enemy_count_ = 0;
+	crate_count_ = 0;
+	coin_count_ = 0;
+	sawblade_count_ = 0;
+	crusher_count_ = 0;
+	wall_count_ = 0;
+	ground_count_ = 0;
+	checkpoint_count_ = 0;
 }
 
 void Level::Update(float frame_time)
 {
+	// Time the whole update, for the frame governor.
+	std::chrono::high_resolution_clock::time_point update_start = std::chrono::high_resolution_clock::now();
+
+	// Forget the sounds that have finished playing.
+	for (size_t i = 0; i < voice_times_.size();)
+	{
+		voice_times_[i] -= frame_time;
+		if (voice_times_[i] <= 0.0f)
+		{
+			voice_times_[i] = voice_times_.back();
+			voice_times_.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+
 	// If finish line hasn't been reached, increase timer by frame time.
-	if (!checkpoints_[3].GetTriggered()) 
+	if (!checkpoints_[checkpoint_count_ - 1].GetTriggered()) 
 	{
 		timer_ += frame_time;
 	}
@@ -36,7 +77,7 @@ void Level::Update(float frame_time)
 	if (player_.GetBody()->GetPosition().y < 0 && player_.GetState() != PlayerState::DEAD)
 	{
 		player_.SetDead();
-		audio_manager_->PlaySample(5); // Play death sound.
+		PlaySound(5); // Play death sound.
 	}
 
 	// Iteratre through each checkpoint.
@@ -46,7 +87,7 @@ void Level::Update(float frame_time)
 		if (checkpoints_[i].GetTriggered())
 		{
 			// If it's the last checkpoint, start increasing the end timer, start dancing and once the timer exceeds 5 seconds change to the win state.
-			if (i == 3)
+			if (i == checkpoint_count_ - 1)
 			{
 				end_timer_ += frame_time;
 				if (end_timer_ > 5)
@@ -62,13 +103,17 @@ void Level::Update(float frame_time)
 	}
 
 	// Handle input.
-	if (input_manager_)
+	// Take every event that happened before this step. Presses that started and ended since the last step still count.
+	if (input_service_)
 	{
-		input_manager_->Update();
-		ProcessTouchInput();
-		ProcessKeyboardInput(frame_time);
-		ProcessControllerInput(frame_time);
+		input_service_->Consume(input_state_, InputService::Now());
 	}
+	ProcessTouchInput();
+	ProcessKeyboardInput(frame_time);
+	ProcessControllerInput(frame_time);
+
+	// Forget this step's presses, ready for the next step's events.
+	input_state_.BeginStep();
 
 	// When the player is running, play footstep sounds.
 	if (player_.GetState() == PlayerState::RUNNING)
@@ -80,13 +125,14 @@ void Level::Update(float frame_time)
 			footstep_timer_ = 0;
 
 			// Play the audio for the footstep based on footstep boolean.
+			// Footsteps are optional, so they are the first sounds dropped when the frame is busy.
 			if (alternate_footsteps_ == false)
 			{
-				audio_manager_->PlaySample(6);
+				PlaySound(6, true);
 			}
 			else
 			{
-				audio_manager_->PlaySample(7);
+				PlaySound(7, true);
 			}
 
 			// Invert the footstep boolean.
@@ -97,12 +143,21 @@ void Level::Update(float frame_time)
 	// Update box2d simulation.
 	UpdateSimulation(frame_time);
 
+	// Update the particles.
+	debris_particles_.Update(frame_time);
+	spark_particles_.Update(frame_time);
+
 	// Update player.
 	player_.Update(frame_time);
 
-	// Update each enemy.
+	// Update each enemy, starting a new frame of shared poses first.
+	// Enemies far from the player animate in bigger steps when the governor asks for it. They still move every frame.
+	enemy_pose_cache_.NewFrame(frame_time);
+	float player_x = player_.GetBody()->GetPosition().x;
 	for (int i = 0; i < enemy_count_; i++)
 	{
+		bool far_away = quality_.far_actor_interval > 1 && fabsf(enemies_[i].GetBody()->GetPosition().x - player_x) > quality_.far_actor_distance;
+		enemies_[i].SetAnimationInterval(far_away ? quality_.far_actor_interval : 1);
 		enemies_[i].Update(frame_time);
 	}
 
@@ -133,18 +188,80 @@ void Level::Update(float frame_time)
 
 	// Set the volume.
 	audio_manager_->SetMasterVolume(*volume_);
+
+	// Save what needs drawing for this frame.
+	BuildSnapshot();
+
+	update_time_ = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - update_start).count();
+}
+
+void Level::SetQuality(const FrameGovernor& governor)
+{
+	quality_ = governor.settings();
+	quality_tier_ = governor.tier();
+	frame_load_ = governor.load();
+
+	enemy_pose_cache_.set_time_step(quality_.anim_time_step);
+	debris_particles_.set_limit((UInt32)(debris_particles_.capacity() * quality_.particle_fraction));
+	spark_particles_.set_limit((UInt32)(spark_particles_.capacity() * quality_.particle_fraction));
+}
+
+void Level::PlaySound(Int32 sample, bool optional)
+{
+	// Optional sounds only play at the tiers that allow them, and never take the last free voice.
+	int max_voices = optional ? quality_.max_voices - 1 : quality_.max_voices;
+	if ((optional && !quality_.optional_sounds) || (int)voice_times_.size() >= max_voices)
+	{
+		return;
+	}
+
+	voice_times_.push_back(sound_length_);
+	audio_manager_->PlaySample(sample);
 }
 
 void Level::Render()
 {
+	// Draw the newest snapshot the simulation has published. The simulation may be writing the next one while this runs.
+	const LevelSnapshot* snapshot = snapshots_.Latest();
+
+	// Nothing has been simulated since the level was reset, so just clear the screen.
+	if (!snapshot)
+	{
+		renderer_3d_->Begin();
+		renderer_3d_->End();
+		return;
+	}
+
+	// Setup camera.
+	renderer_3d_->set_projection_matrix(snapshot->projection_matrix);
+	renderer_3d_->set_view_matrix(snapshot->view_matrix);
+
+	// Draw the queue, which was sorted when the snapshot was built.
+	renderer_3d_->Begin();
+	snapshot->render_queue.Submit(renderer_3d_);
+
+	// Finish rendering 3d objects.
+	renderer_3d_->End();
+
+	// Start drawing sprites, but don't clear the frame buffer.
+	sprite_renderer_->Begin(false);
+
+	// Render the hud, will appear over the 3d objects.
+	RenderHud(*snapshot);
+
+	sprite_renderer_->End();
+}
+
+void Level::BuildSnapshot()
+{
+	LevelSnapshot& snapshot = snapshots_.back();
+
 	// Setup camera.
 
 	// Projection.
 	float fov = gef::DegToRad(45.0f);
 	float aspect_ratio = (float)platform_->width() / (float)platform_->height();
-	gef::Matrix44 projection_matrix;
-	projection_matrix = platform_->PerspectiveProjectionFov(fov, aspect_ratio, 0.1f, 100.0f);
-	renderer_3d_->set_projection_matrix(projection_matrix);
+	snapshot.projection_matrix = platform_->PerspectiveProjectionFov(fov, aspect_ratio, 0.1f, 100.0f);
 
 	// View.
 	gef::Vector4 camera_eye;
@@ -162,135 +279,114 @@ void Level::Render()
 		camera_lookat = gef::Vector4(player_.GetBody()->GetPosition().x, player_.GetBody()->GetPosition().y + 1.0f, 0.0f);
 	}
 
-	// Set 3d renderer to use the camera's view matrix.
+	// Save the camera's view matrix.
 	gef::Vector4 camera_up(0.0f, 1.0f, 0.0f);
-	gef::Matrix44 view_matrix;
-	view_matrix.LookAt(camera_eye, camera_lookat, camera_up);
-	renderer_3d_->set_view_matrix(view_matrix);
+	snapshot.view_matrix.LookAt(camera_eye, camera_lookat, camera_up);
 
 
-	// Draw 3d geometry.
-	renderer_3d_->Begin();
-
-	// Render the ground.
+	// Fill the render queue. Each object only says what to draw and with which material, the queue decides the order.
+	RenderQueue& render_queue = snapshot.render_queue;
+	render_queue.Clear();
 
-	// Set override material, then render each ground object.
-	renderer_3d_->set_override_material(&floor_material_);
+	// Queue the ground and walls.
 	for (int i = 0; i < ground_count_; i++)
 	{
-		renderer_3d_->DrawMesh(ground_[i]);
+		render_queue.AddMesh(PASS_OPAQUE, &floor_material_, ground_[i].mesh(), ground_[i].transform());
 	}
-	
-	// Set override material, then render each wall object.
-	renderer_3d_->set_override_material(&wall_material_);
 	for (int i = 0; i < wall_count_; i++)
 	{
-		renderer_3d_->DrawMesh(wall_[i]);
+		render_queue.AddMesh(PASS_OPAQUE, &wall_material_, wall_[i].mesh(), wall_[i].transform());
 	}
-	
-
-	// Render the player.
-	renderer_3d_->set_override_material(NULL);
-	player_.Render(renderer_3d_);
 
-	// Render the enemies.
-	for (int i = 0; i < enemy_count_; i++)
-	{
-		enemies_[i].Render(renderer_3d_);
-	}
-
-	// Set override material and render the crushers.
-	renderer_3d_->set_override_material(&metal_material_);
+	// Queue the crushers.
 	for (int i = 0; i < crusher_count_; i++)
 	{
-		renderer_3d_->DrawMesh(crushers_[i]);
+		render_queue.AddMesh(PASS_OPAQUE, &metal_material_, crushers_[i].mesh(), crushers_[i].transform());
 	}
-	
-	// Rendering crates.
-	// Determine override material based on type.
+
+	// Queue the crates, with a material based on their type. Destroyed crates queue their planks and released coins instead.
 	for (int i = 0; i < crate_count_; i++)
 	{
+		const gef::Material* crate_material = NULL;
 		switch (crates_[i].GetType())
 		{
 		case CrateType::WOOD:
-			renderer_3d_->set_override_material(&crate__material_);
+			crate_material = &crate__material_;
 			break;
 		case CrateType::METAL:
-			renderer_3d_->set_override_material(&metal_crate_material_);
+			crate_material = &metal_crate_material_;
 			break;
 		case CrateType::JUMP_WOOD:
-			renderer_3d_->set_override_material(&jump_crate_material_);
+			crate_material = &jump_crate_material_;
 			break;
 		case CrateType::JUMP_METAL:
-			renderer_3d_->set_override_material(&metal_jump_crate_material_);
+			crate_material = &metal_jump_crate_material_;
 			break;
 		case CrateType::DESTROYED:
-			renderer_3d_->set_override_material(&wood_material_);
-			crates_[i].RenderPlanks(renderer_3d_); // Render destroyed crate planks with wood material.
+			crates_[i].RenderCoins(&render_queue, &coin_material_);
 			break;
 		}
 
-		// Render if not destroyed.
-		if (crates_[i].GetType() != CrateType::DESTROYED)
+		if (crate_material)
 		{
-			renderer_3d_->DrawMesh(crates_[i]);
-		}	
+			render_queue.AddMesh(PASS_OPAQUE, crate_material, crates_[i].mesh(), crates_[i].transform());
+		}
 	}
 
-	// Render the coins contained in each crate once they have been destroyed.
-	for (int i = 0; i < crate_count_; i++)
+	// Queue the particles. Each system is one mesh and material, so it is drawn as one batch.
+	debris_particles_.Render(&render_queue, PASS_OPAQUE, &wood_material_, plank_mesh_);
+	spark_particles_.Render(&render_queue, PASS_OPAQUE, &metal_material_, spark_mesh_);
+
+	// Queue the player and enemies, which use their models' own materials.
+	player_.Render(&render_queue);
+	for (int i = 0; i < enemy_count_; i++)
 	{
-		if (crates_[i].GetType() == CrateType::DESTROYED) 
-		{
-			renderer_3d_->set_override_material(&coin_material_);
-			crates_[i].RenderCoins(renderer_3d_);
-		}
+		enemies_[i].Render(&render_queue);
 	}
 
-	// Set override material and render all of the coins.
-	renderer_3d_->set_override_material(&coin_material_);
+	// Queue the coins, checkpoints and sawblades. Their textures have transparent parts, so they are drawn after everything else.
 	for (int i = 0; i < coin_count_; i++)
 	{
 		if (!coins_[i].GetCollected())
 		{
-			renderer_3d_->DrawMesh(coins_[i]);
+			render_queue.AddMesh(PASS_ALPHA, &coin_material_, coins_[i].mesh(), coins_[i].transform());
 		}
 	}
-
-	// Set override material and render all of the checkpoints.
-	renderer_3d_->set_override_material(&checkpoint_material_);
 	for (int i = 0; i < checkpoint_count_; i++)
 	{
-		renderer_3d_->DrawMesh(checkpoints_[i]);
+		render_queue.AddMesh(PASS_ALPHA, &checkpoint_material_, checkpoints_[i].mesh(), checkpoints_[i].transform());
 	}
-	
-	// Set override material and render all of the sawblades.
-	renderer_3d_->set_override_material(&sawblade_material_);
 	for (int i = 0; i < sawblade_count_; i++)
 	{
-		renderer_3d_->DrawMesh(sawblades_[i]);
+		render_queue.AddMesh(PASS_ALPHA, &sawblade_material_, sawblades_[i].mesh(), sawblades_[i].transform());
 	}
 
-	// Finish rendering 3d objects.
-	renderer_3d_->End();
-
-	// Start drawing sprites, but don't clear the frame buffer.
-	sprite_renderer_->Begin(false);
-
-	// Render the hud, will appear over the 3d objects.
-	RenderHud();
-
-	sprite_renderer_->End();
+	// Sort by pass, material and mesh here, so the render thread only has to draw.
+	render_queue.Sort();
+
+	// Save the values shown on the hud.
+	snapshot.lives = player_.GetLives();
+	snapshot.timer = timer_;
+	snapshot.score = score_;
+	snapshot.show_physics_stats = show_physics_stats_;
+	snapshot.proxy_count = proxy_count_;
+	snapshot.pair_count = pair_count_;
+	snapshot.touching_count = touching_count_;
+	snapshot.quality_tier = quality_tier_;
+	snapshot.frame_load = frame_load_;
+
+	// Hand the snapshot over to be drawn.
+	snapshots_.Publish();
 }
 
-void Level::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb)
+void Level::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, InputService* is, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb, const LevelLayout& layout)
 {
 	// Set values for all of the pointers.
 	sprite_renderer_ = sr;
 	font_ = f;
 	platform_ = p;
 	game_state_ = gs;
-	input_manager_ = im;
+	input_service_ = is;
 	audio_manager_ = am;
 	main_menu_ = mm;
 	renderer_3d_ = r3d;
@@ -298,21 +394,80 @@ void Level::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameSt
 	volume_ = main_menu_->GetVolume();
 	controller_ = main_menu_->GetController();
 
-	// Tnitialise the physics world.
+	// Tnitialise the physics worlds. The level is split along its length into regions, each with its own world, so
+	// the regions can be stepped in parallel.
+	float min_x = 0.0f;
+	float max_x = 0.0f;
+	for (size_t i = 0; i < layout.ground.size(); i++)
+	{
+		min_x = b2Min(min_x, layout.ground[i].position.x - layout.ground[i].half_extents.x);
+		max_x = b2Max(max_x, layout.ground[i].position.x + layout.ground[i].half_extents.x);
+	}
 	b2Vec2 gravity(0.0f, -9.81f);
-	world_ = new b2World(gravity);
+	physics_regions_.Init(&arena_, gravity, min_x, max_x, physics_region_width_);
 
-	// Initialise objects
-	InitLights();
+	// Initialise objects. Nothing here draws or plays audio, but the meshes and textures are created through the
+	// platform, so a level can only be built on another thread where LevelHost allows it.
 	InitPlayer();
-	InitGround();
-	InitEnemies();
+	InitGround(layout);
+	InitEnemies(layout);
 	InitTextures();
-	InitCrates();
-	InitWall();
-	InitCoins();
-	InitTraps();
-	InitCheckpoints();
+	InitCrates(layout);
+	InitWall(layout);
+	InitCoins(layout);
+	InitTraps(layout);
+	InitCheckpoints(layout);
+
+	// Create the particle meshes.
+	plank_mesh_ = CreateBoxMesh(gef::Vector4(0.1f, 0.4f, 0.02f));
+	spark_mesh_ = CreateBoxMesh(gef::Vector4(0.04f, 0.04f, 0.04f));
+
+	// Box2D allocates bodies and fixtures from its own allocator, so estimate what the worlds hold from their body count.
+	arena_.Track(MEMORY_PHYSICS, physics_regions_.body_count() * (sizeof(b2Body) + sizeof(b2Fixture) + sizeof(b2PolygonShape)));
+
+	// Report what the level has loaded.
+	MemoryTracker::Report();
+}
+
+void Level::CleanUp()
+{
+	// Destroy the physics worlds, meshes, textures and models all at once.
+	physics_regions_.CleanUp();
+	arena_.Release();
+	plank_mesh_ = NULL;
+	spark_mesh_ = NULL;
+	box_meshes_.clear();
+	enemy_pose_cache_.CleanUp();
+
+	// Remove the objects, so the next layout starts from fresh ones.
+	enemies_.clear();
+	crates_.clear();
+	coins_.clear();
+	sawblades_.clear();
+	crushers_.clear();
+	wall_.clear();
+	ground_.clear();
+	ground_half_extents_.clear();
+	checkpoints_.clear();
+	enemy_count_ = 0;
+	crate_count_ = 0;
+	coin_count_ = 0;
+	sawblade_count_ = 0;
+	crusher_count_ = 0;
+	wall_count_ = 0;
+	ground_count_ = 0;
+	checkpoint_count_ = 0;
+	debris_particles_.Clear();
+	spark_particles_.Clear();
+
+	// Forget the snapshots, which point at the meshes and materials that have just been freed.
+	snapshots_.Reset();
+	for (int i = 0; i < SnapshotBuffer<LevelSnapshot>::kBufferCount; i++)
+	{
+		snapshots_.buffer(i).render_queue.Reset();
+	}
+
+	MemoryTracker::Report();
 }
 
 void Level::Reset()
@@ -364,51 +519,55 @@ void Level::Reset()
 	{
 		coins_[i].SetCollected(false);
 	}
+
+	// Remove any particles.
+	debris_particles_.Clear();
+	spark_particles_.Clear();
+
+	// Forget any input from the last time the level was played.
+	input_state_.Clear();
+	active_touch_id_ = -1;
+
+	// Don't draw anything from the last time the level was played.
+	snapshots_.Reset();
+
+	// Forget the sounds from the last time the level was played.
+	voice_times_.clear();
 }
 
 void Level::ProcessTouchInput()
 {
-	// Get touch input.
-	const gef::TouchInputManager* touch_input = input_manager_->touch_manager();
+	// Get the touch events for this step.
+	const std::vector<InputEvent>& touch_events = input_state_.touch_events();
 
-	if (touch_input && (touch_input->max_num_panels() > 0))
+	// go through the touches
+	for (std::vector<InputEvent>::const_iterator touch = touch_events.begin(); touch != touch_events.end(); ++touch)
 	{
-		// get the active touches for this panel
-		const gef::TouchContainer& panel_touches = touch_input->touches(0);
-
-		// go through the touches
-		for (gef::ConstTouchIterator touch = panel_touches.begin(); touch != panel_touches.end(); ++touch)
+		// if active touch id is -1, then we are not currently processing a touch
+		if (active_touch_id_ == -1)
 		{
-			// if active touch id is -1, then we are not currently processing a touch
-			if (active_touch_id_ == -1)
+			// check for the start of a new touch
+			if (touch->type == INPUT_TOUCH_NEW)
 			{
-				// check for the start of a new touch
-				if (touch->type == gef::TT_NEW)
-				{
-					active_touch_id_ = touch->id;
+				active_touch_id_ = touch->code;
 
-					// Set player to attack when a new touch is detected and the player isn't already kicking, dead or dancing.
-					if (player_.GetState() != PlayerState::KICKING && player_.GetState() != PlayerState::DEAD && player_.GetState() != PlayerState::DANCING)
-					{
-						audio_manager_->PlaySample(1); // Play kick sound.
-						player_.Attack();
-					}
+				// Set player to attack when a new touch is detected and the player isn't already kicking, dead or dancing.
+				if (player_.GetState() != PlayerState::KICKING && player_.GetState() != PlayerState::DEAD && player_.GetState() != PlayerState::DANCING)
+				{
+					PlaySound(1); // Play kick sound.
+					player_.Attack();
 				}
 			}
-			else if (active_touch_id_ == touch->id)
+		}
+		else if (active_touch_id_ == touch->code)
+		{
+			// we are processing touch data with a matching id to the one we are looking for
+			if (touch->type == INPUT_TOUCH_RELEASED)
 			{
-				// we are processing touch data with a matching id to the one we are looking for
-				if (touch->type == gef::TT_ACTIVE)
-				{
-					// update an active touch here
-				}
-				else if (touch->type == gef::TT_RELEASED)
-				{
-					// the touch we are tracking has been released
-					// perform any actions that need to happen when a touch is released here
-					// we're not doing anything here apart from resetting the active touch id
-					active_touch_id_ = -1;
-				}
+				// the touch we are tracking has been released
+				// perform any actions that need to happen when a touch is released here
+				// we're not doing anything here apart from resetting the active touch id
+				active_touch_id_ = -1;
 			}
 		}
 	}
@@ -417,7 +576,7 @@ void Level::ProcessTouchInput()
 void Level::ProcessKeyboardInput(float frame_time)
 {
 	// Get keyboad input
-	gef::Keyboard* keyboard = input_manager_->keyboard();
+	const InputState* keyboard = &input_state_;
 	
 	// If the escape key is pressed, pause the game.
 	if (keyboard->IsKeyPressed(gef::Keyboard::KC_ESCAPE))
@@ -425,6 +584,12 @@ void Level::ProcessKeyboardInput(float frame_time)
 		game_state_->SetGameState(State::PAUSED);
 	}
 
+	// Toggle the physics counters with F1.
+	if (keyboard->IsKeyPressed(gef::Keyboard::KC_F1))
+	{
+		show_physics_stats_ = !show_physics_stats_;
+	}
+
 	// If the player isn't dead or dancing...
 	if (player_.GetState() != PlayerState::DEAD && player_.GetState() != PlayerState::DANCING)
 	{
@@ -456,7 +621,7 @@ void Level::ProcessKeyboardInput(float frame_time)
 		{
 			if (player_.GetState() != PlayerState::KICKING)
 			{
-				audio_manager_->PlaySample(1); // Play kick sound.
+				PlaySound(1); // Play kick sound.
 				player_.Attack();
 			}
 		}
@@ -467,60 +632,53 @@ void Level::ProcessControllerInput(float frame_time)
 {
 	if (*controller_ != 0) // If controller isn't set to none...
 	{
-		// Get controller input.
-		gef::SonyControllerInputManager* controller_manager = input_manager_->controller_input();
-		if (controller_manager)
+		// Get the first controller's input.
+		const InputState* controller = &input_state_;
+
+		// Variables for tracking the left analogue stick.
+		float left_x_ = controller->left_stick_x();
+		float left_y_ = controller->left_stick_y();
+
+		// If the player isn't dead or dancing...
+		if (player_.GetState() != PlayerState::DEAD && player_.GetState() != PlayerState::DANCING)
 		{
-			// Get first controller.
-			const gef::SonyController* controller = controller_manager->GetController(0);
-			if (controller)
+			// Move left when stick is moved left or left d pad is down.
+			if (controller->buttons_down() & gef_SONY_CTRL_LEFT || left_x_ < -0.66)
+			{
+				player_.MoveLeft(frame_time);
+			}
+			else if (controller->buttons_down() & gef_SONY_CTRL_RIGHT || left_x_ > 0.66) // Move right when stick is moved right or right d pad is down.
 			{
-				// Variables for tracking the left analogue stick.
-				float left_x_ = controller->left_stick_x_axis();
-				float left_y_ = controller->left_stick_y_axis();
+				player_.MoveRight(frame_time);
+			}
 
-				// If the player isn't dead or dancing...
-				if (player_.GetState() != PlayerState::DEAD && player_.GetState() != PlayerState::DANCING)
+			// If A is pressed on Xbox controller or X is pressed on Playstation controller...
+			if ((controller->buttons_pressed() & gef_SONY_CTRL_SQUARE && *controller_ == 1) || (controller->buttons_pressed() & gef_SONY_CTRL_CROSS && *controller_ == 2))
+			{
+				// Jump if not already jumpng, falling or attacking.
+				if (player_.GetState() != PlayerState::JUMPING && player_.GetState() != PlayerState::FALLING && player_.GetState() != PlayerState::KICKING)
 				{
-					// Move left when stick is moved left or left d pad is down.
-					if (controller->buttons_down() & gef_SONY_CTRL_LEFT || left_x_ < -0.66)
-					{
-						player_.MoveLeft(frame_time);
-					}
-					else if (controller->buttons_down() & gef_SONY_CTRL_RIGHT || left_x_ > 0.66) // Move right when stick is moved right or right d pad is down.
-					{
-						player_.MoveRight(frame_time);
-					}
-
-					// If A is pressed on Xbox controller or X is pressed on Playstation controller...
-					if ((controller->buttons_pressed() & gef_SONY_CTRL_SQUARE && *controller_ == 1) || (controller->buttons_pressed() & gef_SONY_CTRL_CROSS && *controller_ == 2))
-					{
-						// Jump if not already jumpng, falling or attacking.
-						if (player_.GetState() != PlayerState::JUMPING && player_.GetState() != PlayerState::FALLING && player_.GetState() != PlayerState::KICKING)
-						{
-							player_.Jump();
-						}
-					}
-
-					// If X is pressed on Xbox controller or square is pressed on Playstation controller...
-					if ((controller->buttons_pressed() & gef_SONY_CTRL_CIRCLE && *controller_ == 1) || (controller->buttons_pressed() & gef_SONY_CTRL_SQUARE && *controller_ == 2)) // CIRCLE = X on Xbox
-					{
-						// Attack if the player isn't already kicking.
-						if (player_.GetState() != PlayerState::KICKING)
-						{
-							audio_manager_->PlaySample(1); // Play kick sound.
-							player_.Attack();
-						}
-					}
+					player_.Jump();
 				}
+			}
 
-				// If start button is pressed, pause the game.
-				if ((controller->buttons_pressed() & gef_SONY_CTRL_R2 && *controller_ == 1) || (controller->buttons_pressed() & gef_SONY_CTRL_START && *controller_ == 2)) // R2 = Start on XBOX
+			// If X is pressed on Xbox controller or square is pressed on Playstation controller...
+			if ((controller->buttons_pressed() & gef_SONY_CTRL_CIRCLE && *controller_ == 1) || (controller->buttons_pressed() & gef_SONY_CTRL_SQUARE && *controller_ == 2)) // CIRCLE = X on Xbox
+			{
+				// Attack if the player isn't already kicking.
+				if (player_.GetState() != PlayerState::KICKING)
 				{
-					game_state_->SetGameState(State::PAUSED);
+					PlaySound(1); // Play kick sound.
+					player_.Attack();
 				}
 			}
 		}
+
+		// If start button is pressed, pause the game.
+		if ((controller->buttons_pressed() & gef_SONY_CTRL_R2 && *controller_ == 1) || (controller->buttons_pressed() & gef_SONY_CTRL_START && *controller_ == 2)) // R2 = Start on XBOX
+		{
+			game_state_->SetGameState(State::PAUSED);
+		}
 	}
 }
 
@@ -528,7 +686,7 @@ void Level::InitPlayer()
 {
 	// Setup the mesh for the player. Can be rendered if you want to show hitbox.
 	gef::Vector4 hitbox_half_dimensions(0.5f, 0.8f, 0.5f);
-	player_.set_mesh(primitive_builder_->CreateBoxMesh(hitbox_half_dimensions));
+	player_.set_mesh(CreateBoxMesh(hitbox_half_dimensions));
 
 	player_half_height_ = hitbox_half_dimensions.y();
 
@@ -540,7 +698,7 @@ void Level::InitPlayer()
 	// Create a connection between the rigid body and GameObject.
 	player_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&player_);
 
-	player_.SetBody(player_body_def, world_);
+	player_.SetBody(player_body_def, physics_regions_.WorldAt(player_body_def.position.x));
 
 	// Create the shape for the player.
 	b2PolygonShape player_shape;
@@ -552,9 +710,10 @@ void Level::InitPlayer()
 	player_fixture_def.density = 1.0f;
 
 	// Create the fixture on the rigid body.
-	player_.GetBody()->CreateFixture(&player_fixture_def);
+	player_.CreateFixture(player_fixture_def);
 	player_.GetBody()->SetFixedRotation(true);
 	player_.GetBody()->SetSleepingAllowed(false);
+	physics_regions_.Add(&player_);
 
 	// Update visuals from simulation data.
 	player_.UpdateFromSimulation();
@@ -564,14 +723,41 @@ void Level::InitPlayer()
 	player_.SetRespawnPosition(respawn_position_);
 
 	// Initialise things inside the player object.
-	player_.Init(platform_);
+	player_.Init(platform_, &arena_);
 }
 
-void Level::InitEnemies()
+void Level::InitEnemies(const LevelLayout& layout)
 {
-	gef::Scene* enemy_scene = new gef::Scene();
-	enemy_scene->ReadSceneFromFile(*platform_, "enemy/zombie.scn");
-	enemy_scene->CreateMaterials(*platform_);
+	// Load the enemy model once for all enemies, preferring the cooked version.
+	gef::Mesh* enemy_mesh;
+	gef::Skeleton* enemy_skeleton;
+	CookedScene* enemy_cooked_scene = arena_.New<CookedScene>(MEMORY_MESHES);
+	if (enemy_cooked_scene->Load("enemy/zombie.scnb", *platform_))
+	{
+		arena_.Track(MEMORY_MESHES, enemy_cooked_scene->mesh_bytes());
+		arena_.Track(MEMORY_TEXTURES, enemy_cooked_scene->texture_bytes());
+		enemy_mesh = enemy_cooked_scene->mesh();
+		enemy_skeleton = enemy_cooked_scene->skeleton();
+	}
+	else
+	{
+		// The parsed scene's size isn't known, so use the size of the file it was read from.
+		gef::Scene* enemy_scene = arena_.Adopt(new gef::Scene(), MEMORY_MESHES, AssetBlob::FileSize("enemy/zombie.scn"));
+		enemy_scene->ReadSceneFromFile(*platform_, "enemy/zombie.scn");
+		enemy_scene->CreateMaterials(*platform_);
+		enemy_mesh = MotionClipPlayer::GetFirstMesh(enemy_scene, platform_);
+		enemy_skeleton = MotionClipPlayer::GetFirstSkeleton(enemy_scene);
+	}
+
+	// Load the animations once, every enemy shares them.
+	AnimClip* idle_anim = LoadClip("enemy/anim-zombie-idle.scn");
+	AnimClip* run_anim = LoadClip("enemy/anim-zombie-run.scn");
+
+	// Every enemy has the same skeleton, so they can share sampled poses.
+	if (enemy_skeleton)
+	{
+		enemy_pose_cache_.Init(*enemy_skeleton);
+	}
 
 	// Setup the mesh for the enemy. Can be rendered if you want to show hitbox.
 	gef::Vector4 hitbox_half_dimensions(0.3f, 0.8f, 0.5f);
@@ -589,66 +775,43 @@ void Level::InitEnemies()
 	enemy_fixture_def.shape = &enemy_shape;
 	enemy_fixture_def.density = 1.0f;
 
+	// Create the enemy objects.
+	enemy_count_ = (int)layout.enemies.size();
+	enemies_.resize(enemy_count_);
+
 	for (int i = 0; i < enemy_count_; i++)
 	{
 		// Apply mesh to the enemy.
-		enemies_[i].set_mesh(primitive_builder_->CreateBoxMesh(hitbox_half_dimensions));
+		enemies_[i].set_mesh(CreateBoxMesh(hitbox_half_dimensions));
 
 		// Setup each enemy's position and path.
-		switch (i)
-		{
-		case 0:
-			enemy_body_def.position = b2Vec2(36.0f, 14.5f);
-			enemies_[i].SetPath(4, 4);
-			break;
-		case 1:
-			enemy_body_def.position = b2Vec2(56.0f, 14.5f);
-			enemies_[i].SetPath(3, 4);
-			break;
-		case 2:
-			enemy_body_def.position = b2Vec2(94.0f, 14.5f);
-			enemies_[i].SetPath(2, 0);
-			break;
-		case 3:
-			enemy_body_def.position = b2Vec2(142.0f, 14.5f);
-			enemies_[i].SetPath(3, 2);
-			break;
-		case 4:
-			enemy_body_def.position = b2Vec2(158.0f, 14.5f);
-			enemies_[i].SetPath(2, 1);
-			break;
-		case 5:
-			enemy_body_def.position = b2Vec2(224.0f, 14.5f);
-			enemies_[i].SetPath(2, 1);
-			break;
-		case 6:
-			enemy_body_def.position = b2Vec2(230.0f, 14.5f);
-			enemies_[i].SetPath(2, 3);
-			break;
-		default:
-			break;
-		}
-		
+		enemy_body_def.position = layout.enemies[i].position;
+		enemies_[i].SetPath(layout.enemies[i].walk_distance, layout.enemies[i].idle_time);
+
 		// Create a connection between the rigid body and GameObject.
 		enemy_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&enemies_[i]);
 
-		enemies_[i].SetBody(enemy_body_def, world_);
+		enemies_[i].SetBody(enemy_body_def, physics_regions_.WorldAt(enemy_body_def.position.x));
 
 		// Create the fixture on the rigid body.
-		enemies_[i].GetBody()->CreateFixture(&enemy_fixture_def); 
+		enemies_[i].CreateFixture(enemy_fixture_def); 
 
 		// Set so it can't rotate.
 		enemies_[i].GetBody()->SetFixedRotation(true);
+		physics_regions_.Add(&enemies_[i]);
 
 		// Update visuals from simulation data.
 		enemies_[i].UpdateFromSimulation();
 
+		// Spread the enemies over the phase groups.
+		enemies_[i].SetPhase((float)(i % enemy_phase_groups_) / (float)enemy_phase_groups_);
+
 		// Initialise things inside the enemy object.
-		enemies_[i].Init(platform_, enemy_scene);
+		enemies_[i].Init(platform_, enemy_mesh, enemy_skeleton, idle_anim, run_anim, &enemy_pose_cache_, &arena_);
 	}
 }
 
-void Level::InitGround()
+void Level::InitGround(const LevelLayout& layout)
 {
 	// Ground dimensions.
 	gef::Vector4 ground_half_dimensions;
@@ -663,82 +826,48 @@ void Level::InitGround()
 	// The fixture.
 	b2FixtureDef fixture_def;
 
+	// Create the ground objects.
+	ground_count_ = (int)layout.ground.size();
+	ground_.resize(ground_count_);
+	ground_half_extents_.resize(ground_count_);
+
 	for (int i = 0; i < ground_count_; i++)
 	{
 		ground_[i].set_type(OBJECT_TYPE::GROUND);
 
-		switch (i)
-		{
-		case 0:
-			ground_half_dimensions = gef::Vector4(10.0f, 2.5f, 0.5f);
-			body_def.position = b2Vec2(0.0f, 0.0f);
-			break;
-		case 1:
-			ground_half_dimensions = gef::Vector4(10.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(25.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 2:
-			ground_half_dimensions = gef::Vector4(5.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(52.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 3:
-			ground_half_dimensions = gef::Vector4(5.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(67.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 4:
-			ground_half_dimensions = gef::Vector4(13.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(90.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 5:
-			ground_half_dimensions = gef::Vector4(4.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(120.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 6:
-			ground_half_dimensions = gef::Vector4(19.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(132.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 7:
-			ground_half_dimensions = gef::Vector4(10.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(192.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 8:
-			ground_half_dimensions = gef::Vector4(7.5f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(220.0f + ground_half_dimensions.x(), 14.0f);
-			break;
-		case 9:
-			ground_half_dimensions = gef::Vector4(5.0f, 0.5f, 0.5f);
-			body_def.position = b2Vec2(250.0f + ground_half_dimensions.x(), 24.0f);
-			break;
-		default:
-			ground_half_dimensions = gef::Vector4(0.0f, 0.0f, 0.0f);
-			body_def.position = b2Vec2(0.0f, 0.0f);
-			break;
-		}
+		// Position and size the piece of ground.
+		const GroundPiece& piece = layout.ground[i];
+		ground_half_dimensions = gef::Vector4(piece.half_extents.x, piece.half_extents.y, 0.5f);
+		body_def.position = piece.position;
+
+		// Save the ground's size.
+		ground_half_extents_[i] = b2Vec2(ground_half_dimensions.x(), ground_half_dimensions.y());
 
 		// Setup the mesh for the ground.
-		gef::Mesh* ground_mesh = primitive_builder_->CreateBoxMesh(ground_half_dimensions);
+		gef::Mesh* ground_mesh = CreateBoxMesh(ground_half_dimensions);
 		ground_[i].set_mesh(ground_mesh);
 
 		// Setup the physics body for the ground.
 		body_def.userData.pointer = reinterpret_cast<uintptr_t>(&ground_[i]);
-		ground_[i].SetBody(body_def, world_);
+		ground_[i].SetBody(body_def, physics_regions_.WorldAt(body_def.position.x));
 
 		// Setup shape and fixture def.
 		shape.SetAsBox(ground_half_dimensions.x(), ground_half_dimensions.y());
 		fixture_def.shape = &shape;
 
 		// Create the fixture on the rigid body.
-		ground_[i].GetBody()->CreateFixture(&fixture_def);
+		ground_[i].CreateFixture(fixture_def);
+		physics_regions_.Add(&ground_[i]);
 
 		// Update visuals from simulation data.
 		ground_[i].UpdateFromSimulation();
 	}
 }
 
-void Level::InitLights()
+void Level::InitLights(gef::Renderer3D* renderer_3d)
 {
 	// grab the data for the default shader used for rendering 3D geometry
-	gef::Default3DShaderData& default_shader_data = renderer_3d_->default_shader_data();
+	gef::Default3DShaderData& default_shader_data = renderer_3d->default_shader_data();
 
 	// set the ambient light
 	default_shader_data.set_ambient_light_colour(gef::Colour(0.25f, 0.25f, 0.25f, 1.0f));
@@ -753,63 +882,30 @@ void Level::InitLights()
 
 void Level::InitTextures()
 {
-	// Load each texture from a file, then apply it to the relevant material.
-	gef::ImageData texture_image;
-	gef::PNGLoader png_loader;
-	gef::Texture* texture;
-
-	png_loader.Load("textures/floor.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	floor_material_.set_texture(texture);
-
-	png_loader.Load("textures/crate.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	crate__material_.set_texture(texture);
-
-	png_loader.Load("textures/jump_crate.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	jump_crate_material_.set_texture(texture);
-
-	png_loader.Load("textures/metal_crate.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	metal_crate_material_.set_texture(texture);
-
-	png_loader.Load("textures/jump_metal_crate.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	metal_jump_crate_material_.set_texture(texture);
-
-	png_loader.Load("textures/metal.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	metal_material_.set_texture(texture);
-
-	png_loader.Load("textures/wall.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	wall_material_.set_texture(texture);
-
-	png_loader.Load("textures/wood.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	wood_material_.set_texture(texture);
-
-	png_loader.Load("textures/coin.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	coin_material_.set_texture(texture);
-
-	png_loader.Load("textures/sawblade.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	sawblade_material_.set_texture(texture);
-
-	png_loader.Load("textures/checkpoint.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	checkpoint_material_.set_texture(texture);
+	// Load each texture, from its cooked blob if there is one, then apply it to the relevant material.
+	floor_material_.set_texture(LoadLevelTexture("textures/floor.png"));
+	crate__material_.set_texture(LoadLevelTexture("textures/crate.png"));
+	jump_crate_material_.set_texture(LoadLevelTexture("textures/jump_crate.png"));
+	metal_crate_material_.set_texture(LoadLevelTexture("textures/metal_crate.png"));
+	metal_jump_crate_material_.set_texture(LoadLevelTexture("textures/jump_metal_crate.png"));
+	metal_material_.set_texture(LoadLevelTexture("textures/metal.png"));
+	wall_material_.set_texture(LoadLevelTexture("textures/wall.png"));
+	wood_material_.set_texture(LoadLevelTexture("textures/wood.png"));
+	coin_material_.set_texture(LoadLevelTexture("textures/coin.png"));
+	sawblade_material_.set_texture(LoadLevelTexture("textures/sawblade.png"));
+	checkpoint_material_.set_texture(LoadLevelTexture("textures/checkpoint.png"));
 }
 
-void Level::InitCrates()
+void Level::InitCrates(const LevelLayout& layout)
 {
 	// Setup the mesh for the crate.
 	gef::Vector4 hitbox_half_dimensions(0.5f, 0.5f, 0.5f);
 
 	crate_half_height_ = hitbox_half_dimensions.y();
 
+	// The coins inside the crates share a mesh with everything else their size.
+	gef::Mesh* crate_coin_mesh = crate_count_ > 0 ? CreateBoxMesh(Crate::GetCoinHalfDimensions()) : NULL;
+
 	// Create a physics body for the crate.
 	b2BodyDef crate_body_def;
 	crate_body_def.type = b2_staticBody;
@@ -823,209 +919,49 @@ void Level::InitCrates()
 	crate_fixture_def.shape = &crate_shape;
 	crate_fixture_def.density = 1.0f;
 
+	// Create the crate objects.
+	crate_count_ = (int)layout.crates.size();
+	crates_.resize(crate_count_);
+
 	for (int i = 0; i < crate_count_; i++)
 	{
 		// Set crate's object type.
 		crates_[i].set_type(OBJECT_TYPE::CRATE);
 
 		// Create crate's mesh.
-		crates_[i].set_mesh(primitive_builder_->CreateBoxMesh(hitbox_half_dimensions));
-	
+		crates_[i].set_mesh(CreateBoxMesh(hitbox_half_dimensions));
 
-		
 		// Set each crates position and type.
-		switch (i)
-		{
-		case 0:
-			crate_body_def.position = b2Vec2(0.0f, 3.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 1:
-			crate_body_def.position = b2Vec2(5.0f, 3.0f);
-			crates_[i].SetType(CrateType::JUMP_WOOD);
-			break;
-		case 2:
-			crate_body_def.position = b2Vec2(5.0f, 7.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 3:
-			crate_body_def.position = b2Vec2(9.5f, 3.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 4:
-			crate_body_def.position = b2Vec2(15.0f, 7.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 5:
-			crate_body_def.position = b2Vec2(20.0f, 11.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 6:
-			crate_body_def.position = b2Vec2(45.5f, 14.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 7:
-			crate_body_def.position = b2Vec2(46.5f, 14.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 8:
-			crate_body_def.position = b2Vec2(47.5f, 14.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 9:
-			crate_body_def.position = b2Vec2(48.5f, 14.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 10:
-			crate_body_def.position = b2Vec2(49.5f, 14.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 11:
-			crate_body_def.position = b2Vec2(50.5f, 14.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 12:
-			crate_body_def.position = b2Vec2(51.5f, 14.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 13:
-			crate_body_def.position = b2Vec2(70.0f, 15.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 14:
-			crate_body_def.position = b2Vec2(71.5f, 16.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 15:
-			crate_body_def.position = b2Vec2(73.5f, 19.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 16:
-			crate_body_def.position = b2Vec2(81.0f, 14.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 17:
-			crate_body_def.position = b2Vec2(86.0f, 14.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 18:
-			crate_body_def.position = b2Vec2(112.0f, 15.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 19:
-			crate_body_def.position = b2Vec2(135.0f, 15.0f);
-			crates_[i].SetType(CrateType::JUMP_WOOD);
-			break;
-		case 20:
-			crate_body_def.position = b2Vec2(133.0f, 19.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 21:
-			crate_body_def.position = b2Vec2(137.0f, 19.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 22:
-			crate_body_def.position = b2Vec2(168.0f, 20.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 23:
-			crate_body_def.position = b2Vec2(172.0f, 14.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 24:
-			crate_body_def.position = b2Vec2(175.0f, 16.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 25:
-			crate_body_def.position = b2Vec2(172.0f, 18.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 26:
-			crate_body_def.position = b2Vec2(176.0f, 20.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 27:
-			crate_body_def.position = b2Vec2(182.0f, 22.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 28:
-			crate_body_def.position = b2Vec2(180.0f, 14.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 29:
-			crate_body_def.position = b2Vec2(181.0f, 14.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 30:
-			crate_body_def.position = b2Vec2(182.0f, 14.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 31:
-			crate_body_def.position = b2Vec2(187.0f, 18.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 32:
-			crate_body_def.position = b2Vec2(209.0f, 15.0f);
-			crates_[i].SetType(CrateType::JUMP_WOOD);
-			break;
-		case 33:
-			crate_body_def.position = b2Vec2(205.5f, 20.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 34:
-			crate_body_def.position = b2Vec2(200.5f, 20.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 35:
-			crate_body_def.position = b2Vec2(216.0f, 14.0f);
-			crates_[i].SetType(CrateType::METAL);
-			break;
-		case 36:
-			crate_body_def.position = b2Vec2(240.0f, 14.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 37:
-			crate_body_def.position = b2Vec2(245.0f, 19.0f);
-			crates_[i].SetType(CrateType::JUMP_METAL);
-			break;
-		case 38:
-			crate_body_def.position = b2Vec2(235.0f, 19.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		case 39:
-			crate_body_def.position = b2Vec2(240.0f, 24.0f);
-			crates_[i].SetType(CrateType::WOOD);
-			break;
-		default:
-			break;
-		}
+		crate_body_def.position = layout.crates[i].position;
+		crates_[i].SetType(layout.crates[i].type);
 		
 		// Create a connection between the rigid body and GameObject.
 		crate_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&crates_[i]);
 
-		crates_[i].SetBody(crate_body_def, world_);
+		crates_[i].SetBody(crate_body_def, physics_regions_.WorldAt(crate_body_def.position.x));
 
 		// Create the fixture on the rigid body.
-		crates_[i].GetBody()->CreateFixture(&crate_fixture_def);
+		crates_[i].CreateFixture(crate_fixture_def);
 
 		// Set so crate can't rotate.
 		crates_[i].GetBody()->SetFixedRotation(true);
+		physics_regions_.Add(&crates_[i]);
 
 		// Update visuals from simulation data.
 		crates_[i].UpdateFromSimulation();
 
 		// Initialise things inside the crate.
-		crates_[i].Init(primitive_builder_, world_);
+		crates_[i].Init(crate_coin_mesh, &physics_regions_, &debris_particles_, GroundHeightBelow(crate_body_def.position.x, crate_body_def.position.y));
 	}
 }
 
-void Level::InitWall()
+void Level::InitWall(const LevelLayout& layout)
 {
 	// Wall dimensions.
 	gef::Vector4 wall_half_dimensions(10.0f, 10.0f, 0.5f);
 
 	// Setup the mesh for the wall.
-	gef::Mesh* wall_mesh = primitive_builder_->CreateBoxMesh(wall_half_dimensions);
+	gef::Mesh* wall_mesh = CreateBoxMesh(wall_half_dimensions);
 	
 	// Variables for setting wall transformation.
 	gef::Matrix44 rotX, rotY, rotZ, trans, final, scale;
@@ -1036,9 +972,14 @@ void Level::InitWall()
 	rotZ.RotationZ(0);
 	
 
+	// Create the wall objects.
+	wall_count_ = layout.wall_count;
+	wall_.resize(wall_count_);
+
 	for (int i = 0; i < wall_count_; i++)
 	{
-		// Apply mesh to wall.
+		// Set wall's object type and apply mesh to wall.
+		wall_[i].set_type(OBJECT_TYPE::WALL);
 		wall_[i].set_mesh(wall_mesh);
 
 		gef::Vector4 position;
@@ -1056,7 +997,7 @@ void Level::InitWall()
 			// Create a connection between the rigid body and GameObject.
 			wall_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&wall_[i]);
 
-			wall_[i].SetBody(wall_body_def, world_);
+			wall_[i].SetBody(wall_body_def, physics_regions_.WorldAt(wall_body_def.position.x));
 
 			// Create the shape for the wall.
 			b2PolygonShape wall_shape;
@@ -1068,8 +1009,9 @@ void Level::InitWall()
 			wall_fixture_def.density = 1.0f;
 
 			// Create the fixture on the rigid body.
-			wall_[i].GetBody()->CreateFixture(&wall_fixture_def);
+			wall_[i].CreateFixture(wall_fixture_def);
 			wall_[i].GetBody()->SetFixedRotation(true);
+			physics_regions_.Add(&wall_[i]);
 		}
 		// Next if and else position the walls in 2 rows.
 		else if (i < (wall_count_ / 2) - 1)
@@ -1090,7 +1032,7 @@ void Level::InitWall()
 	}
 }
 
-void Level::InitCoins()
+void Level::InitCoins(const LevelLayout& layout)
 {
 	// Setup the mesh for the coin.
 	gef::Vector4 hitbox_half_dimensions(0.3f, 0.3f, 0.0f);
@@ -1108,151 +1050,40 @@ void Level::InitCoins()
 	coin_fixture_def.shape = &coin_shape;
 	coin_fixture_def.density = 1.0f;
 
+	// Create the coin objects.
+	coin_count_ = (int)layout.coins.size();
+	coins_.resize(coin_count_);
+
 	for (int i = 0; i < coin_count_; i++)
 	{
 		// Set coin's object type.
 		coins_[i].set_type(OBJECT_TYPE::COIN);
 		
 		// Apply mesh to the coin.
-		coins_[i].set_mesh(primitive_builder_->CreateBoxMesh(hitbox_half_dimensions));
+		coins_[i].set_mesh(CreateBoxMesh(hitbox_half_dimensions));
 	
 		// Position each coin.
-		switch (i)
-		{
-		case 0:
-			coin_body_def.position = b2Vec2(-6.0f, 3.5f);
-			break;
-		case 1:
-			coin_body_def.position = b2Vec2(-4.0f, 3.5f);
-			break;
-		case 2:
-			coin_body_def.position = b2Vec2(-2.0f, 3.5f);
-			break;
-		case 3:
-			coin_body_def.position = b2Vec2(9.5f, 4.5f);
-			break;
-		case 4:
-			coin_body_def.position = b2Vec2(9.5f, 6.5f);
-			break;
-		case 5:
-			coin_body_def.position = b2Vec2(9.5f, 8.5f);
-			break;
-		case 6:
-			coin_body_def.position = b2Vec2(15.0f, 8.5f);
-			break;
-		case 7:
-			coin_body_def.position = b2Vec2(15.0f, 10.5f);
-			break;
-		case 8:
-			coin_body_def.position = b2Vec2(15.0f, 12.5f);
-			break;
-		case 9:
-			coin_body_def.position = b2Vec2(20.0f, 12.5f);
-			break;
-		case 10:
-			coin_body_def.position = b2Vec2(20.0f, 14.5f);
-			break;
-		case 11:
-			coin_body_def.position = b2Vec2(20.0f, 16.5f);
-			break;
-		case 12:
-			coin_body_def.position = b2Vec2(81.0f, 15.5f);
-			break;
-		case 13:
-			coin_body_def.position = b2Vec2(86.0f, 15.5f);
-			break;
-		case 14:
-			coin_body_def.position = b2Vec2(120.0f, 16.5f);
-			break;
-		case 15:
-			coin_body_def.position = b2Vec2(124.0f, 16.5f);
-			break;
-		case 16:
-			coin_body_def.position = b2Vec2(128.0f, 16.5f);
-			break;
-		case 17:
-			coin_body_def.position = b2Vec2(135.0f, 16.5f);
-			break;
-		case 18:
-			coin_body_def.position = b2Vec2(135.0f, 18.5f);
-			break;
-		case 19:
-			coin_body_def.position = b2Vec2(135.0f, 20.5f);
-			break;
-		case 20:
-			coin_body_def.position = b2Vec2(148.0f, 15.5f);
-			break;
-		case 21:
-			coin_body_def.position = b2Vec2(151.0f, 15.5f);
-			break;
-		case 22:
-			coin_body_def.position = b2Vec2(154.0f, 15.5f);
-			break;
-		case 23:
-			coin_body_def.position = b2Vec2(172.0f, 15.5f);
-			break;
-		case 24:
-			coin_body_def.position = b2Vec2(175.0f, 17.5f);
-			break;
-		case 25:
-			coin_body_def.position = b2Vec2(172.0f, 19.5f);
-			break;
-		case 26:
-			coin_body_def.position = b2Vec2(176.0f, 21.5f);
-			break;
-		case 27:
-			coin_body_def.position = b2Vec2(187.0f, 19.5f);
-			break;
-		case 28:
-			coin_body_def.position = b2Vec2(209.0f, 16.5f);
-			break;
-		case 29:
-			coin_body_def.position = b2Vec2(209.0f, 18.5f);
-			break;
-		case 30:
-			coin_body_def.position = b2Vec2(209.0f, 20.5f);
-			break;
-		case 31:
-			coin_body_def.position = b2Vec2(240.0f, 15.5f);
-			break;
-		case 32:
-			coin_body_def.position = b2Vec2(240.0f, 17.5f);
-			break;
-		case 33:
-			coin_body_def.position = b2Vec2(240.0f, 19.5f);
-			break;
-		case 34:
-			coin_body_def.position = b2Vec2(245.0f, 20.5f);
-			break;
-		case 35:
-			coin_body_def.position = b2Vec2(245.0f, 22.5f);
-			break;
-		case 36:
-			coin_body_def.position = b2Vec2(245.0f, 24.5f);
-			break;
-		default:
-			break;
-		}
-
+		coin_body_def.position = layout.coins[i];
 
 		// Create a connection between the rigid body and GameObject.
 		coin_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&coins_[i]);
 
-		coins_[i].SetBody(coin_body_def, world_);
+		coins_[i].SetBody(coin_body_def, physics_regions_.WorldAt(coin_body_def.position.x));
 
 		// Create the fixture on the rigid body.
-		coins_[i].GetBody()->CreateFixture(&coin_fixture_def);
+		coins_[i].CreateFixture(coin_fixture_def);
 
 		// Set coin to have no rotation and be a sensor.
 		coins_[i].GetBody()->SetFixedRotation(true);
 		coins_[i].GetBody()->GetFixtureList()->SetSensor(true);
+		physics_regions_.Add(&coins_[i]);
 
 		// Update visuals from simulation data.
 		coins_[i].UpdateFromSimulation();
 	}
 }
 
-void Level::InitTraps()
+void Level::InitTraps(const LevelLayout& layout)
 {
 	// Half dimensions of the sawblade.
 	gef::Vector4 saw_half_dimensions;
@@ -1270,71 +1101,37 @@ void Level::InitTraps()
 	saw_fixture_def.shape = &saw_shape;
 	saw_fixture_def.density = 1.0f;
 
+	// Create the sawblade objects.
+	sawblade_count_ = (int)layout.sawblades.size();
+	sawblades_.resize(sawblade_count_);
+
 	for (int i = 0; i < sawblade_count_; i++)
 	{
+		const SawbladePlacement& sawblade = layout.sawblades[i];
+
 		sawblades_[i].set_type(OBJECT_TYPE::SAWBLADE);
-		if (i == 3)
-		{
-			saw_half_dimensions = gef::Vector4(0.5f, 0.5f, 0.0f);
-		}
-		else
-		{
-			saw_half_dimensions = gef::Vector4(1.0f, 1.0f, 0.0f);
-		}
-		sawblades_[i].set_mesh(primitive_builder_->CreateBoxMesh(saw_half_dimensions));
+		saw_half_dimensions = gef::Vector4(sawblade.half_size, sawblade.half_size, 0.0f);
+		sawblades_[i].set_mesh(CreateBoxMesh(saw_half_dimensions));
 		
 	
 		// Create a connection between the rigid body and GameObject.
 		saw_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&sawblades_[i]);
 
-		sawblades_[i].SetBody(saw_body_def, world_);
+		sawblades_[i].SetBody(saw_body_def, physics_regions_.WorldAt(sawblade.position.x));
 
-		if (i == 3)
-		{
-			saw_shape.SetAsBox(0.8 * saw_half_dimensions.x(), 0.8 * saw_half_dimensions.y());
-		}
-		else
-		{
-			saw_shape.SetAsBox(0.8 * saw_half_dimensions.x(), 0.8 * saw_half_dimensions.y());
-		}
+		saw_shape.SetAsBox(0.8 * saw_half_dimensions.x(), 0.8 * saw_half_dimensions.y());
 
 		// Create the fixture on the rigid body.
-		sawblades_[i].GetBody()->CreateFixture(&saw_fixture_def);
+		sawblades_[i].CreateFixture(saw_fixture_def);
 
 		// Set rotation to be fixed and object to be a sensor.
 		sawblades_[i].GetBody()->SetFixedRotation(true);
 		sawblades_[i].GetBody()->GetFixtureList()->SetSensor(true);
 
 		// Position and initialise each sawblade.
-		switch (i)
-		{
-		case 0:
-			sawblades_[i].GetBody()->SetTransform(b2Vec2(79, 11), 0);
-			sawblades_[i].Init(2, 0, 6);
-			break;
-		case 1:
-			sawblades_[i].GetBody()->SetTransform(b2Vec2(83.5, 11), 0);
-			sawblades_[i].Init(4, 0, 6);
-			break;
-		case 2:
-			sawblades_[i].GetBody()->SetTransform(b2Vec2(88, 11), 0);
-			sawblades_[i].Init(2, 0, 6);
-			break;
-		case 3:
-			sawblades_[i].GetBody()->SetTransform(b2Vec2(124, 15.5), 0);
-			sawblades_[i].Init(0, 2, 3);
-			break;
-		case 4:
-			sawblades_[i].GetBody()->SetTransform(b2Vec2(200.5, 15.5), 0);
-			sawblades_[i].Init(2, 0, 3);
-			break;
-		case 5:
-			sawblades_[i].GetBody()->SetTransform(b2Vec2(205.5, 15.5), 0);
-			sawblades_[i].Init(2, 0, 3);
-			break;
-		default:
-			break;
-		}
+		sawblades_[i].GetBody()->SetTransform(sawblade.position, 0);
+		physics_regions_.Add(&sawblades_[i]);
+		sawblades_[i].Init(sawblade.vertical_speed, sawblade.horizontal_speed, sawblade.distance);
 
 		
 		// Update visuals from simulation data.
@@ -1360,58 +1157,32 @@ void Level::InitTraps()
 	crusher_fixture_def.shape = &crusher_shape;
 	crusher_fixture_def.density = 1.0f;
 
+	// Create the crusher objects.
+	crusher_count_ = (int)layout.crushers.size();
+	crushers_.resize(crusher_count_);
+
 	for (int i = 0; i < crusher_count_; i++)
 	{
 		// Set game object type to crusher.
 		crushers_[i].set_type(OBJECT_TYPE::CRUSHER);
 
 		// Create mesh for crusher.
-		crushers_[i].set_mesh(primitive_builder_->CreateBoxMesh(crusher_half_dimensions));
+		crushers_[i].set_mesh(CreateBoxMesh(crusher_half_dimensions));
 		
 		// Create a connection between the rigid body and GameObject.
 		crusher_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&crushers_[i]);
 
-		crushers_[i].SetBody(crusher_body_def, world_);
+		crushers_[i].SetBody(crusher_body_def, physics_regions_.WorldAt(layout.crushers[i].position.x));
 
 
 		// Create the fixture on the rigid body.
-		crushers_[i].GetBody()->CreateFixture(&crusher_fixture_def);
+		crushers_[i].CreateFixture(crusher_fixture_def);
 		crushers_[i].GetBody()->SetFixedRotation(true);
 
 		// Position and initialise each crusher.
-		switch (i)
-		{
-		case 0:
-			crushers_[i].GetBody()->SetTransform(b2Vec2(100, 20), 0);
-			crushers_[i].Init(0, 3);
-			break;
-		case 1:
-			crushers_[i].GetBody()->SetTransform(b2Vec2(104, 20), 0);
-			crushers_[i].Init(3, 3);
-			break;
-		case 2:
-			crushers_[i].GetBody()->SetTransform(b2Vec2(108, 20), 0);
-			crushers_[i].Init(0, 3);
-			break;
-		case 3:
-			crushers_[i].GetBody()->SetTransform(b2Vec2(148, 20), 0);
-			crushers_[i].Init(0, 0.5);
-			break;
-		case 4:
-			crushers_[i].GetBody()->SetTransform(b2Vec2(151, 20), 0);
-			crushers_[i].Init(0.5, 0.5);
-			break;
-		case 5:
-			crushers_[i].GetBody()->SetTransform(b2Vec2(154, 20), 0);
-			crushers_[i].Init(1, 0.5);
-			break;
-		case 6:
-			crushers_[i].GetBody()->SetTransform(b2Vec2(203, 20), 0);
-			crushers_[i].Init(0, 3);
-			break;
-		default:
-			break;
-		}
+		crushers_[i].GetBody()->SetTransform(layout.crushers[i].position, 0);
+		physics_regions_.Add(&crushers_[i]);
+		crushers_[i].Init(layout.crushers[i].delay, layout.crushers[i].interval);
 
 		// Update visuals from simulation data.
 		crushers_[i].UpdateFromSimulation();
@@ -1419,7 +1190,7 @@ void Level::InitTraps()
 	
 }
 
-void Level::InitCheckpoints()
+void Level::InitCheckpoints(const LevelLayout& layout)
 {
 	// Checkpoint's half dimensions.
 	gef::Vector4 hitbox_half_dimensions(0.3f, 0.3f, 0.0f);
@@ -1437,32 +1208,20 @@ void Level::InitCheckpoints()
 	checkpoint_fixture_def.shape = &checkpoint_shape;
 	checkpoint_fixture_def.density = 1.0f;
 
+	// Create the checkpoint objects.
+	checkpoint_count_ = (int)layout.checkpoints.size();
+	checkpoints_.resize(checkpoint_count_);
+
 	for (int i = 0; i < checkpoint_count_; i++)
 	{
 		// Set game object's type to checkpoint.
 		checkpoints_[i].set_type(OBJECT_TYPE::CHECKPOINT);
 
 		// Setup the mesh for the checkpoint.
-		checkpoints_[i].set_mesh(primitive_builder_->CreateBoxMesh(hitbox_half_dimensions));
+		checkpoints_[i].set_mesh(CreateBoxMesh(hitbox_half_dimensions));
 		
 		// Position each checkpoint.
-		switch (i)
-		{
-		case 0:
-			checkpoint_body_def.position = b2Vec2(68.0f, 15.0f);
-			break;
-		case 1:
-			checkpoint_body_def.position = b2Vec2(114.0f, 15.0f);
-			break;
-		case 2:
-			checkpoint_body_def.position = b2Vec2(168.0f, 15.0f);
-			break;
-		case 3:
-			checkpoint_body_def.position = b2Vec2(253.0f, 25.0f);
-			break;
-		default:
-			break;
-		}
+		checkpoint_body_def.position = layout.checkpoints[i];
 
 		// Set the checkpoint's transform.
 		gef::Matrix44 rotX, rotY, rotZ, trans, final, scale;
@@ -1482,15 +1241,66 @@ void Level::InitCheckpoints()
 		// Create a connection between the rigid body and GameObject.
 		checkpoint_body_def.userData.pointer = reinterpret_cast<uintptr_t>(&checkpoints_[i]);
 
-		checkpoints_[i].SetBody(checkpoint_body_def, world_);
+		checkpoints_[i].SetBody(checkpoint_body_def, physics_regions_.WorldAt(checkpoint_body_def.position.x));
 
 		// Create the fixture on the rigid body.
-		checkpoints_[i].GetBody()->CreateFixture(&checkpoint_fixture_def);
+		checkpoints_[i].CreateFixture(checkpoint_fixture_def);
 
 		// Set to have fixed rotation and be a sensor.
 		checkpoints_[i].GetBody()->SetFixedRotation(true);
 		checkpoints_[i].GetBody()->GetFixtureList()->SetSensor(true);
+		physics_regions_.Add(&checkpoints_[i]);
+	}
+}
+
+gef::Mesh* Level::CreateBoxMesh(const gef::Vector4& half_dimensions)
+{
+	// Objects with the same dimensions share a mesh, so the render queue can group their draws.
+	for (size_t i = 0; i < box_meshes_.size(); i++)
+	{
+		const gef::Vector4& size = box_meshes_[i].half_dimensions;
+		if (size.x() == half_dimensions.x() && size.y() == half_dimensions.y() && size.z() == half_dimensions.z())
+		{
+			return box_meshes_[i].mesh;
+		}
+	}
+
+	BoxMesh box_mesh;
+	box_mesh.half_dimensions = half_dimensions;
+	box_mesh.mesh = arena_.Adopt(primitive_builder_->CreateBoxMesh(half_dimensions), MEMORY_MESHES, PrimitiveBuilder::BoxMeshByteSize());
+	box_meshes_.push_back(box_mesh);
+	return box_mesh.mesh;
+}
+
+gef::Texture* Level::LoadLevelTexture(const char* png_filename)
+{
+	UInt32 byte_size = 0;
+	gef::Texture* texture = LoadTexture(png_filename, *platform_, &byte_size);
+	return arena_.Adopt(texture, MEMORY_TEXTURES, byte_size);
+}
+
+AnimClip* Level::LoadClip(const char* anim_scene_filename)
+{
+	AnimClip* clip = MotionClipPlayer::LoadAnimation(anim_scene_filename, "", platform_);
+	return arena_.Adopt(clip, MEMORY_ANIMATION, clip ? clip->memory_size() : 0);
+}
+
+float Level::GroundHeightBelow(float x, float y)
+{
+	// Below the kill height, so particles with no ground under them fall out of the level.
+	float height = -10.0f;
+
+	for (int i = 0; i < ground_count_; i++)
+	{
+		const b2Vec2& position = ground_[i].GetBody()->GetPosition();
+		float top = position.y + ground_half_extents_[i].y;
+		if (fabsf(x - position.x) <= ground_half_extents_[i].x && top <= y && top > height)
+		{
+			height = top;
+		}
 	}
+
+	return height;
 }
 
 void Level::UpdateSimulation(float frame_time)
@@ -1501,7 +1311,10 @@ void Level::UpdateSimulation(float frame_time)
 	int32 velocityIterations = 6;
 	int32 positionIterations = 2;
 
-	world_->Step(timeStep, velocityIterations, positionIterations);
+	// Time the step, for the stress test and the physics counters. It includes moving objects between regions.
+	std::chrono::high_resolution_clock::time_point step_start = std::chrono::high_resolution_clock::now();
+	physics_regions_.Step(timeStep, velocityIterations, positionIterations);
+	step_time_ = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - step_start).count();
 
 	// Update player visuals from simulation data.
 	player_.UpdateFromSimulation();
@@ -1535,15 +1348,22 @@ void Level::UpdateSimulation(float frame_time)
 
 
 	// Collision detection.
-	// Get the head of the contact list.
-	b2Contact* contact = world_->GetContactList();
-	// Get contact count.
-	int contact_count = world_->GetContactCount();
+	// Get the contacts from every region. Every broadphase pair that passes the collision filter becomes a contact.
+	physics_regions_.GatherContacts(contacts_);
+	int contact_count = (int)contacts_.size();
+
+	// Record the physics counters for this step.
+	proxy_count_ = physics_regions_.proxy_count();
+	pair_count_ = physics_regions_.contact_count();
+	touching_count_ = 0;
 
 	for (int contact_num = 0; contact_num < contact_count; ++contact_num)
 	{
+		b2Contact* contact = contacts_[contact_num];
 		if (contact->IsTouching())
 		{
+			touching_count_++;
+
 			// get the colliding bodies
 			b2Body* bodyA = contact->GetFixtureA()->GetBody();
 			b2Body* bodyB = contact->GetFixtureB()->GetBody();
@@ -1647,9 +1467,26 @@ void Level::UpdateSimulation(float frame_time)
 					// Play metallic clang sound if player is close enough.
 					if (player_.GetBody()->GetPosition().x > crusher->GetBody()->GetPosition().x - audio_proximity_ && player_.GetBody()->GetPosition().x < crusher->GetBody()->GetPosition().x + audio_proximity_)
 					{
-						audio_manager_->PlaySample(9);
+						PlaySound(9);
 					}
 
+					// Throw sparks out from the bottom of the crusher.
+					ParticleBurst sparks;
+					float crusher_bottom = crusher->GetBody()->GetPosition().y - crusher_half_height_;
+					sparks.position = gef::Vector4(crusher->GetBody()->GetPosition().x, crusher_bottom, 0.0f);
+					sparks.position_spread = gef::Vector4(1.0f, 0.0f, 0.5f);
+					sparks.velocity_min_x = -6.0f;
+					sparks.velocity_max_x = 6.0f;
+					sparks.velocity_min_y = 2.0f;
+					sparks.velocity_max_y = 8.0f;
+					sparks.spin_min = -20.0f;
+					sparks.spin_max = 20.0f;
+					sparks.lifetime_min = 0.3f;
+					sparks.lifetime_max = 0.8f;
+					sparks.floor_y = crusher_bottom;
+					sparks.count = 40;
+					spark_particles_.Emit(sparks);
+
 					// Set the crusher to be finished.
 					crusher->SetFinished(true);
 				}
@@ -1697,12 +1534,12 @@ void Level::UpdateSimulation(float frame_time)
 							if (difX < 0)
 							{
 								enemy->SetDead(Direction::LEFT); // Launch enemy based on the attacking direction.
-								audio_manager_->PlaySample(4); // Play enemy death sound.
+								PlaySound(4); // Play enemy death sound.
 							}
 							else // Otherwise it'll be right.
 							{
 								enemy->SetDead(Direction::RIGHT); // Launch enemy based on the attacking direction.
-								audio_manager_->PlaySample(4); // Play enemy death sound.
+								PlaySound(4); // Play enemy death sound.
 							}
 						}
 						else if (difY > 0) // If the player lands around the enemy's head...
@@ -1710,13 +1547,13 @@ void Level::UpdateSimulation(float frame_time)
 							enemy->SetDead(Direction::UP); // Launch enemy based on the attacking direction.
 							player->GetBody()->ApplyForceToCenter(b2Vec2(0, 400), true); // Launch player up a bit.
 							player->SetState(PlayerState::JUMPING); // Set player's state to jumping.
-							audio_manager_->PlaySample(2); // Play bounce sound.
+							PlaySound(2); // Play bounce sound.
 						}
 						else
 						{
 							// The enemy kills the player.
 							player->SetDead();
-							audio_manager_->PlaySample(5); // Play death sound.
+							PlaySound(5); // Play death sound.
 						}
 					}
 				}
@@ -1738,15 +1575,15 @@ void Level::UpdateSimulation(float frame_time)
 						{
 							player->GetBody()->ApplyForceToCenter(b2Vec2(0, 1000), true);
 							player->SetState(PlayerState::JUMPING);
-							audio_manager_->PlaySample(2);
+							PlaySound(2);
 						}
 						// If it's a wooden crate, launch the player slightly in the air, set state to jumping, play the bounce and crate destroyed sounds, then destroy the crate.
 						else if (crate->GetType() == CrateType::WOOD)
 						{
 							player->GetBody()->ApplyForceToCenter(b2Vec2(0, 500), true);
 							player->SetState(PlayerState::JUMPING);
-							audio_manager_->PlaySample(3);
-							audio_manager_->PlaySample(2);
+							PlaySound(3);
+							PlaySound(2);
 							crate->Destroy();
 						}
 					}
@@ -1757,7 +1594,7 @@ void Level::UpdateSimulation(float frame_time)
 						if ((crate->GetType() == CrateType::WOOD) || (crate->GetType() == CrateType::JUMP_WOOD))
 						{
 							crate->Destroy();
-							audio_manager_->PlaySample(3);
+							PlaySound(3);
 						}
 					}
 
@@ -1765,7 +1602,7 @@ void Level::UpdateSimulation(float frame_time)
 					if (difY < -2.5 && crate->GetType() == CrateType::WOOD)
 					{
 						crate->Destroy();
-						audio_manager_->PlaySample(3);
+						PlaySound(3);
 					}
 				}
 				
@@ -1777,7 +1614,7 @@ void Level::UpdateSimulation(float frame_time)
 					{
 						score_ += 1;
 						coin->SetCollected(true);
-						audio_manager_->PlaySample(8);
+						PlaySound(8);
 					}
 					
 				}
@@ -1786,7 +1623,7 @@ void Level::UpdateSimulation(float frame_time)
 				if (sawblade && player->GetState() != PlayerState::DEAD)
 				{
 					player->SetDead();
-					audio_manager_->PlaySample(5);
+					PlaySound(5);
 				}
 
 				// If the player collides with the crusher and isn't dead...
@@ -1799,7 +1636,7 @@ void Level::UpdateSimulation(float frame_time)
 					if (difY < -crusher_half_height_ && crusher->GetCrushing())
 					{
 						player->SetDead();
-						audio_manager_->PlaySample(5);
+						PlaySound(5);
 					}
 					else if (difY > 0) // Otherwise if above, land on the crusher.
 					{
@@ -1811,13 +1648,10 @@ void Level::UpdateSimulation(float frame_time)
 				}
 			}
 		}
-
-		// Get next contact point.
-		contact = contact->GetNext();
 	}
 }
 
-void Level::RenderHud()
+void Level::RenderHud(const LevelSnapshot& snapshot)
 {
 	// Render the remaining lives, time passed, and coins collected at the top of the screen.
 	font_->RenderText(
@@ -1827,7 +1661,7 @@ void Level::RenderHud()
 		0xffffffff,
 		gef::TJ_LEFT,
 		"LIVES: %i",
-		player_.GetLives());
+		snapshot.lives);
 
 	font_->RenderText(
 		sprite_renderer_,
@@ -1836,7 +1670,7 @@ void Level::RenderHud()
 		0xffffffff,
 		gef::TJ_CENTRE,
 		"TIME: %.1fs",
-		timer_);
+		snapshot.timer);
 
 	font_->RenderText(
 		sprite_renderer_,
@@ -1845,5 +1679,28 @@ void Level::RenderHud()
 		0xffffffff,
 		gef::TJ_RIGHT,
 		"COINS: %i",
-		score_);
+		snapshot.score);
+
+	// Render the physics counters for the last step if enabled.
+	if (snapshot.show_physics_stats)
+	{
+		font_->RenderText(
+			sprite_renderer_,
+			gef::Vector4(platform_->width() * 0.05f, platform_->height() * 0.12f, 0.0f),
+			0.75f,
+			0xffffffff,
+			gef::TJ_LEFT,
+			"PROXIES: %i  PAIRS: %i  TOUCHING: %i",
+			snapshot.proxy_count, snapshot.pair_count, snapshot.touching_count);
+
+		// And the quality tier the frame governor has picked, with how busy recent frames were.
+		font_->RenderText(
+			sprite_renderer_,
+			gef::Vector4(platform_->width() * 0.05f, platform_->height() * 0.17f, 0.0f),
+			0.75f,
+			0xffffffff,
+			gef::TJ_LEFT,
+			"QUALITY: %s  LOAD: %.0f%%",
+			FrameGovernor::TierName(snapshot.quality_tier), snapshot.frame_load * 100.0f);
+	}
 }
@@ -29,20 +29,100 @@
 #include "sawblade.h"
 #include "crusher.h"
 #include "checkpoint.h"
+#include "level_arena.h"
+#include "render_queue.h"
+#include "particle_system.h"
+#include "snapshot_buffer.h"
+#include "input_service.h"
+#include "level_layout.h"
+#include "physics_regions.h"
+#include "frame_governor.h"
+#include <vector>
 
 class MainMenu;
 
+// Everything needed to draw one frame of the level. Built by the simulation and only read by the renderer,
+// so it holds copies of the camera, transforms, bone matrices and hud values rather than pointing at live objects.
+struct LevelSnapshot
+{
+	gef::Matrix44 projection_matrix;
+	gef::Matrix44 view_matrix;
+
+	// The frame's draws, already sorted by pass, material and mesh.
+	RenderQueue render_queue;
+
+	// Values shown on the hud.
+	int lives;
+	float timer;
+	int score;
+	bool show_physics_stats;
+	int proxy_count;
+	int pair_count;
+	int touching_count;
+	QUALITY_TIER quality_tier;
+	float frame_load;
+};
+
 class Level
 {
 public:
 	Level();
 
 	// Functions for updating, rendering, initialising and reseting the level.
+	// Update doesn't touch the renderer, it publishes a snapshot of the frame instead. Render draws the newest snapshot,
+	// so Update can run on the simulation thread while Render draws the frame before.
 	void Update(float frame_time);
 	void Render();
-	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb);
+	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, InputService* is, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb, const LevelLayout& layout);
 	void Reset();
 
+	// Frees everything the level created. Init can be called again afterwards.
+	void CleanUp();
+
+	// Sets up the lights, which are shared by every level. Uses the renderer, so must be called from the main thread.
+	static void InitLights(gef::Renderer3D* renderer_3d);
+
+	// Applies an input event as if it came from the input service, e.g. from a scripted player. It is used by the next Update.
+	void ApplyInput(const InputEvent& event)
+	{
+		input_state_.Apply(event);
+	};
+
+	// Getters for the physics counters and how long the last physics step took in milliseconds, used by the stress test.
+	int GetProxyCount()
+	{
+		return proxy_count_;
+	};
+	int GetPairCount()
+	{
+		return pair_count_;
+	};
+	int GetTouchingCount()
+	{
+		return touching_count_;
+	};
+	float GetStepTime()
+	{
+		return step_time_;
+	};
+
+	// Getter for how long the last Update took in milliseconds, for the frame governor.
+	float GetUpdateTime()
+	{
+		return update_time_;
+	};
+
+	// Sets how much optional work the level does from the governor's quality tier: how often the enemies' poses are
+	// sampled, how many particles can be alive, how many sounds play at once and how smoothly far enemies animate.
+	// None of it changes gameplay. Call between updates, not while the level is being simulated.
+	void SetQuality(const FrameGovernor& governor);
+
+	// Getter for the player's position.
+	b2Vec2 GetPlayerPosition()
+	{
+		return player_.GetBody()->GetPosition();
+	};
+
 	// Getters for the score and time of the level, to be used in the end screen.
 	int GetScore()
 	{
@@ -59,35 +139,49 @@ private:
 	void ProcessKeyboardInput(float frame_time);
 	void ProcessControllerInput(float frame_time);
 
-	// Functions for initialising each of the objects in the world.
+	// Functions for initialising each of the objects in the world, where the layout places them.
 	void InitPlayer();
-	void InitEnemies();
-	void InitGround();
-	void InitLights();
+	void InitEnemies(const LevelLayout& layout);
+	void InitGround(const LevelLayout& layout);
 	void InitTextures();
-	void InitCrates();
-	void InitWall();
-	void InitCoins();
-	void InitTraps();
-	void InitCheckpoints();
+	void InitCrates(const LevelLayout& layout);
+	void InitWall(const LevelLayout& layout);
+	void InitCoins(const LevelLayout& layout);
+	void InitTraps(const LevelLayout& layout);
+	void InitCheckpoints(const LevelLayout& layout);
+
+	// Creates a box mesh owned by the level's arena, or returns the existing one with the same dimensions.
+	gef::Mesh* CreateBoxMesh(const gef::Vector4& half_dimensions);
+
+	// Loads a texture and an animation clip into the level's arena.
+	gef::Texture* LoadLevelTexture(const char* png_filename);
+	AnimClip* LoadClip(const char* anim_scene_filename);
+
+	// Returns the height of the top of the highest piece of ground below a point, for particles to land on.
+	float GroundHeightBelow(float x, float y);
+
+	// Plays a sound effect, unless too many are already playing. Optional sounds are dropped first.
+	void PlaySound(Int32 sample, bool optional = false);
 
 	// Function for the box2d physics simulation.
 	void UpdateSimulation(float frame_time);
 
+	// Fills the next snapshot with the camera, the sorted draws and the hud values, then publishes it.
+	void BuildSnapshot();
+
 	// Function for rendering the hud.
-	void RenderHud();
+	void RenderHud(const LevelSnapshot& snapshot);
 
 	// Pointers that the level needs.
 	gef::SpriteRenderer* sprite_renderer_;
 	gef::Font* font_;
 	gef::Platform* platform_;
-	gef::InputManager* input_manager_;
+	InputService* input_service_;
 	gef::AudioManager* audio_manager_;
 	GameState* game_state_;
 	gef::Renderer3D* renderer_3d_;
 	PrimitiveBuilder* primitive_builder_;
 	MainMenu* main_menu_;
-	b2World* world_;
 	int* volume_;
 	int* controller_;
 
@@ -110,9 +204,43 @@ private:
 	float crate_half_height_;
 	float crusher_half_height_;
 
+	// The input for the current step, built from the input service's events.
+	InputState input_state_;
+
 	// For handling touch input.
 	Int32 active_touch_id_;
 
+	// The physics worlds, one for each region along the level, and the narrowest a region can be.
+	PhysicsRegions physics_regions_;
+	const float physics_region_width_ = 64.0f;
+
+	// The contacts from every region for the last step.
+	std::vector<b2Contact*> contacts_;
+
+	// Physics counters for the last step: broadphase proxies, pairs that passed the collision filter, and pairs that are touching.
+	int proxy_count_;
+	int pair_count_;
+	int touching_count_;
+
+	// How long the last physics step took, in milliseconds.
+	float step_time_;
+
+	// How long the last Update took, in milliseconds.
+	float update_time_;
+
+	// The optional work allowed by the frame governor, and its tier and load for the hud.
+	QualitySettings quality_;
+	QUALITY_TIER quality_tier_;
+	float frame_load_;
+
+	// How long each sound effect that was started recently has left to play. The audio manager can't say which voices
+	// are still playing, so each sound is assumed to last sound_length_ seconds.
+	std::vector<float> voice_times_;
+	const float sound_length_ = 0.5f;
+
+	// Bool for whether the physics counters are shown on the hud.
+	bool show_physics_stats_;
+
 	// The player's respawn position, changes when checkpoints are activated.
 	b2Vec2 respawn_position_;
 
@@ -138,37 +266,64 @@ private:
 	// The player.
 	Player player_;
 
-	// Objects that make up the world. Arrays used as there is a fixed amount of them.
+	// Everything the level loads or creates, released in one go when the level is cleaned up.
+	LevelArena arena_;
+
+	// The box meshes that have been created, so objects with the same dimensions can share one.
+	struct BoxMesh
+	{
+		gef::Vector4 half_dimensions;
+		gef::Mesh* mesh;
+	};
+	std::vector<BoxMesh> box_meshes_;
+
+	// Snapshots of the frames for drawing. The simulation fills one while the renderer reads another.
+	SnapshotBuffer<LevelSnapshot> snapshots_;
+
+	// Cosmetic particles: planks and splinters from destroyed crates, and sparks from the crushers. Neither touches the physics world.
+	ParticleSystem debris_particles_;
+	ParticleSystem spark_particles_;
+	gef::Mesh* plank_mesh_;
+	gef::Mesh* spark_mesh_;
+
+	// Objects that make up the world, sized from the layout when the level is built.
+	// The vectors are only resized before any bodies are created, as each body points back at its object.
 	// Enemies.
-	const int enemy_count_ = 7;
-	Enemy enemies_[7];
+	int enemy_count_;
+	std::vector<Enemy> enemies_;
+
+	// The poses shared by the enemies. Enemies are spread over a few phases so they don't move in step,
+	// while still sharing poses with the other enemies in their phase.
+	PoseCache enemy_pose_cache_;
+	const int enemy_phase_groups_ = 3;
 	
 	// Crates.
-	const int crate_count_ = 40;
-	Crate crates_[40];
+	int crate_count_;
+	std::vector<Crate> crates_;
 	
 	// Coins.
-	const int coin_count_ = 37;
-	Coin coins_[37];
+	int coin_count_;
+	std::vector<Coin> coins_;
 	
 	// Sawblades.
-	const int sawblade_count_ = 6;
-	Sawblade sawblades_[6];
+	int sawblade_count_;
+	std::vector<Sawblade> sawblades_;
 	
 	// Crushers.
-	const int crusher_count_ = 7;
-	Crusher crushers_[7];
+	int crusher_count_;
+	std::vector<Crusher> crushers_;
 
 	// Walls.
-	const int wall_count_ = 31;
-	GameObject wall_[31];
+	int wall_count_;
+	std::vector<GameObject> wall_;
 	
-	// The ground.
-	const int ground_count_ = 10;
-	GameObject ground_[10];
+	// The ground, and the half size of each piece for working out where particles land.
+	int ground_count_;
+	std::vector<GameObject> ground_;
+	std::vector<b2Vec2> ground_half_extents_;
 	
-	// Checkpoints.
-	const int checkpoint_count_ = 4;
-	Checkpoint checkpoints_[4];
+	// Checkpoints. The last one is the finish line.
+	int checkpoint_count_;
+	std::vector<Checkpoint> checkpoints_;
 };
 
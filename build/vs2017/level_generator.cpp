@@ -0,0 +1,168 @@
+#include "level_generator.h"
+#include <cmath>
+
+namespace
+{
+	// Objects per metre in the hand-placed level, which is about 256m long.
+	const float kCratesPerMetre = 40.0f / 256.0f;
+	const float kCoinsPerMetre = 37.0f / 256.0f;
+	const float kEnemiesPerMetre = 7.0f / 256.0f;
+	const float kSawbladesPerMetre = 6.0f / 256.0f;
+	const float kCrushersPerMetre = 7.0f / 256.0f;
+
+	// Distance between checkpoints.
+	const float kCheckpointSpacing = 64.0f;
+
+	// Every piece of ground has its top at the same height as the start, so the player can always jump the gaps.
+	const float kGroundHalfHeight = 2.5f;
+	const float kGroundTop = 2.5f;
+
+	// Width of the background wall panels.
+	const float kWallWidth = 20.0f;
+}
+
+LevelGenerator::LevelGenerator(UInt32 seed)
+{
+	// Zero would give a poor first few numbers, so mix the seed in.
+	random_seed_ = seed * 2654435761u + 1u;
+}
+
+LevelLayout LevelGenerator::Generate(float length, float density)
+{
+	LevelLayout layout;
+
+	// The start platform, the same as the hand-placed level's so the player spawns on it.
+	layout.AddGround(0.0f, 0.0f, 10.0f, kGroundHalfHeight);
+
+	float x = 10.0f;
+	float next_checkpoint = kCheckpointSpacing;
+	while (x < length)
+	{
+		// Leave a gap, then add a piece of ground.
+		float gap = Random(2.0f, 4.0f);
+		float half_width = Random(5.0f, 15.0f);
+		float start = x + gap;
+		float centre = start + half_width;
+		float end = centre + half_width;
+		layout.AddGround(centre, 0.0f, half_width, kGroundHalfHeight);
+
+		float piece_length = 2.0f * half_width;
+
+		// A sawblade moving up and down through some of the gaps, like the hand-placed ones.
+		float sawblade_count = kSawbladesPerMetre * density * (piece_length + gap);
+		int gap_sawblades = RandomCount(sawblade_count * 0.5f);
+		for (int i = 0; i < gap_sawblades; i++)
+		{
+			layout.AddSawblade(x + gap * 0.5f, kGroundTop - 3.5f, 1.0f, 2.0f, 0.0f, 6.0f);
+		}
+
+		// The rest of the sawblades slide back and forth above the ground.
+		int ground_sawblades = RandomCount(sawblade_count * 0.5f);
+		for (int i = 0; i < ground_sawblades; i++)
+		{
+			layout.AddSawblade(Random(start + 3.0f, end - 3.0f), kGroundTop + 1.0f, 0.5f, 0.0f, 2.0f, 3.0f);
+		}
+
+		// Crates, stacked in columns a metre apart.
+		size_t first_crate = layout.crates.size();
+		int crate_count = RandomCount(kCratesPerMetre * density * piece_length);
+		while (crate_count > 0)
+		{
+			int height = 1 + (int)Random(0.0f, 4.0f);
+			if (height > crate_count)
+				height = crate_count;
+			AddCrateStack(layout, first_crate, floorf(Random(start + 1.0f, end - 1.0f)) + 0.5f, kGroundTop, height);
+			crate_count -= height;
+		}
+
+		// Coins floating above the ground.
+		int coin_count = RandomCount(kCoinsPerMetre * density * piece_length);
+		for (int i = 0; i < coin_count; i++)
+		{
+			layout.AddCoin(Random(start + 0.5f, end - 0.5f), kGroundTop + Random(1.0f, 5.0f));
+		}
+
+		// Enemies walking back and forth, keeping to their piece of ground. Every piece is at least 10m long, so there's room.
+		int enemy_count = RandomCount(kEnemiesPerMetre * density * piece_length);
+		for (int i = 0; i < enemy_count; i++)
+		{
+			float walk_distance = Random(1.0f, 4.0f);
+			layout.AddEnemy(Random(start + walk_distance, end - walk_distance), kGroundTop, walk_distance, Random(0.0f, 4.0f));
+		}
+
+		// Crushers hanging above the ground.
+		int crusher_count = RandomCount(kCrushersPerMetre * density * piece_length);
+		for (int i = 0; i < crusher_count; i++)
+		{
+			layout.AddCrusher(Random(start + 1.0f, end - 1.0f), kGroundTop + 5.5f, Random(0.0f, 3.0f), Random(0.5f, 3.0f));
+		}
+
+		// A checkpoint at the start of the first piece of ground past each checkpoint distance.
+		if (start > next_checkpoint)
+		{
+			layout.AddCheckpoint(start + 1.0f, kGroundTop + 0.5f);
+			next_checkpoint += kCheckpointSpacing;
+		}
+
+		x = end;
+	}
+
+	// The finish line at the end of the last piece of ground.
+	layout.AddCheckpoint(x - 2.0f, kGroundTop + 0.5f);
+
+	// Enough wall panels to cover the whole level in two rows, plus the one at the start.
+	layout.wall_count = 2 * ((int)(x / kWallWidth) + 2) + 1;
+
+	return layout;
+}
+
+float LevelGenerator::Random(float min, float max)
+{
+	// the same lcg as the particle system, so a seed gives the same level on every platform
+	random_seed_ = random_seed_ * 1664525u + 1013904223u;
+	float t = (random_seed_ >> 8) * (1.0f / 16777216.0f);
+	return min + (max - min) * t;
+}
+
+int LevelGenerator::RandomCount(float expected)
+{
+	// Round up or down at random, weighted by the fraction, so the counts add up to the expected total over a level.
+	int count = (int)expected;
+	if (Random(0.0f, 1.0f) < expected - (float)count)
+	{
+		count++;
+	}
+	return count;
+}
+
+void LevelGenerator::AddCrateStack(LevelLayout& layout, size_t first_crate, float x, float ground_top, int height)
+{
+	// Find the top of any crates already in this column.
+	float y = ground_top + 0.5f;
+	for (size_t i = first_crate; i < layout.crates.size(); i++)
+	{
+		const b2Vec2& position = layout.crates[i].position;
+		if (position.x == x && position.y + 1.0f > y)
+		{
+			y = position.y + 1.0f;
+		}
+	}
+
+	for (int i = 0; i < height; i++)
+	{
+		// Mostly plain wooden crates, with some metal and jump crates. Jump crates only go on top, where they can be landed on.
+		CrateType type = CrateType::WOOD;
+		float roll = Random(0.0f, 1.0f);
+		if (roll > 0.8f)
+		{
+			type = CrateType::METAL;
+		}
+		else if (roll > 0.65f && i == height - 1)
+		{
+			type = roll > 0.725f ? CrateType::JUMP_METAL : CrateType::JUMP_WOOD;
+		}
+
+		layout.AddCrate(x, y, type);
+		y += 1.0f;
+	}
+}
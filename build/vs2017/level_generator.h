@@ -0,0 +1,29 @@
+#pragma once
+#include "level_layout.h"
+
+// Builds level layouts from the same pieces as the hand-placed level: stretches of ground with gaps between them,
+// stacks of crates, patrolling enemies, coins, sawblades, crushers and checkpoints.
+// The same seed always gives the same level, so runs can be compared.
+class LevelGenerator
+{
+public:
+	LevelGenerator(UInt32 seed);
+
+	// Generates a level.
+	// Length is how far the level goes in metres. The hand-placed level is about 256m.
+	// Density scales how many objects there are per metre. At 1 it's about the same as the hand-placed level.
+	LevelLayout Generate(float length, float density);
+
+private:
+	// Returns a random number between min and max.
+	float Random(float min, float max);
+
+	// Returns a whole number of objects that averages out at the expected count.
+	int RandomCount(float expected);
+
+	// Adds a column of crates, on top of any already in that column. Only crates from first_crate on are checked,
+	// so pass the first crate on this piece of ground rather than searching the whole level.
+	void AddCrateStack(LevelLayout& layout, size_t first_crate, float x, float ground_top, int height);
+
+	UInt32 random_seed_;
+};
@@ -0,0 +1,130 @@
+#include "level_host.h"
+#include <chrono>
+
+LevelHost::LevelHost()
+{
+	// Set default values. Level 0 is built first, level 1 isn't played until level 0 has been swapped in.
+	current_ = 1;
+	next_ = 0;
+	next_ready_ = false;
+	level_requested_ = false;
+	render_time_ = 0.0f;
+}
+
+void LevelHost::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, InputService* is, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb)
+{
+	// Set values for all of the pointers.
+	sprite_renderer_ = sr;
+	font_ = f;
+	platform_ = p;
+	game_state_ = gs;
+	input_service_ = is;
+	audio_manager_ = am;
+	main_menu_ = mm;
+	renderer_3d_ = r3d;
+	primitive_builder_ = pb;
+
+	// Every level is built from the hand-placed layout.
+	layout_ = LevelLayout::HandPlaced();
+
+	// The lights are shared by every level and belong to the renderer, so set them up once here rather than on the build thread.
+	Level::InitLights(renderer_3d_);
+
+	// Start building the first level while the splash screen and menu run.
+	BuildNext();
+}
+
+void LevelHost::Update()
+{
+	// Finish the last frame's simulation, so the game state it set can be acted on.
+	sim_thread_.Wait();
+
+	// Swap at the frame boundary, so nothing is using either level while the swap happens.
+	if (level_requested_ && next_ready_)
+	{
+		if (build_thread_.joinable())
+		{
+			build_thread_.join();
+		}
+
+		// Swap the levels and start the new one.
+		int old_level = current_;
+		current_ = next_;
+		next_ = old_level;
+		level_requested_ = false;
+
+		levels_[current_].Reset();
+		game_state_->SetGameState(State::LEVEL);
+
+		// Start the new level at full quality, without the times from loading or the menus.
+		governor_.Reset();
+		render_time_ = 0.0f;
+
+		// Rebuild the level that was just left, so the next restart is ready too.
+		BuildNext();
+	}
+}
+
+void LevelHost::UpdateLevel(float frame_time)
+{
+	Level* level = GetLevel();
+
+	// The last simulation has been waited for, so it's safe to change the level's settings before starting the next.
+	// The simulation and rendering run at the same time, so both are measured against the whole frame budget.
+	governor_.AddPhaseTime(PHASE_SIMULATION, level->GetUpdateTime() * 0.001f);
+	governor_.AddPhaseTime(PHASE_RENDER, render_time_ * 0.001f);
+	governor_.Update();
+	level->SetQuality(governor_);
+
+	sim_thread_.Kick([level, frame_time]()
+	{
+		level->Update(frame_time);
+	});
+}
+
+void LevelHost::RenderLevel()
+{
+	std::chrono::high_resolution_clock::time_point render_start = std::chrono::high_resolution_clock::now();
+	GetLevel()->Render();
+	render_time_ = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - render_start).count();
+}
+
+void LevelHost::RequestLevel()
+{
+	level_requested_ = true;
+}
+
+void LevelHost::CleanUp()
+{
+	// Wait for the simulation and build threads, then free both levels.
+	sim_thread_.Wait();
+	if (build_thread_.joinable())
+	{
+		build_thread_.join();
+	}
+
+	levels_[0].CleanUp();
+	levels_[1].CleanUp();
+	next_ready_ = false;
+}
+
+void LevelHost::BuildNext()
+{
+	next_ready_ = false;
+
+	Level* level = &levels_[next_];
+	auto build = [this, level]()
+	{
+		// Free what the level had before, then build it again. Everything it creates is owned by the level, so nothing is shared with the level being played.
+		level->CleanUp();
+		level->Init(sprite_renderer_, font_, platform_, game_state_, input_service_, audio_manager_, main_menu_, renderer_3d_, primitive_builder_, layout_);
+		next_ready_ = true;
+	};
+
+#if LEVEL_HOST_BUILD_THREAD
+	build_thread_ = std::thread(build);
+#else
+	// The platform's graphics objects can't be created off the main thread, so build the level now.
+	build();
+#endif
+}
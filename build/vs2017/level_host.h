@@ -0,0 +1,96 @@
+#pragma once
+#include "level.h"
+#include "worker_thread.h"
+#include <thread>
+#include <atomic>
+
+class MainMenu;
+
+// Building a level creates and frees textures and vertex and index buffers through the shared platform while the
+// main thread renders. That is only safe on D3D11, where gef creates and releases them through the ID3D11Device,
+// which is free-threaded, and never through the immediate context the main thread draws with. Other platforms,
+// like the Vita, build levels on the main thread instead.
+#if defined(_WIN32)
+#define LEVEL_HOST_BUILD_THREAD 1
+#else
+#define LEVEL_HOST_BUILD_THREAD 0
+#endif
+
+// Holds two levels, so the next level can be built while the current one is played.
+// Where LEVEL_HOST_BUILD_THREAD is set, the next level is built on a background thread while the current screen keeps
+// running, so starting or restarting a level doesn't stall the game. Elsewhere it is built on the main thread straight
+// after each swap, which stalls that one frame. Either way the finished level is swapped in at the start of a frame.
+class LevelHost
+{
+public:
+	LevelHost();
+
+	// Stores the pointers each level needs, and starts building the first level in the background.
+	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, InputService* is, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb);
+
+	// Called at the start of each frame. Waits for the last frame's simulation, then swaps in the next level if one
+	// has been requested and has finished building.
+	void Update();
+
+	// Starts simulating a frame of the level being played on the simulation thread. It runs while the previous
+	// frame's snapshot is rendered, and is waited for at the start of the next frame.
+	void UpdateLevel(float frame_time);
+
+	// Draws the level being played, timing it for the frame governor.
+	void RenderLevel();
+
+	// Asks for a freshly built level. The game switches to the level state on the first frame it is ready.
+	void RequestLevel();
+
+	// Waits for any level being simulated or built, then frees both levels.
+	void CleanUp();
+
+	// Getter for the level being played.
+	Level* GetLevel()
+	{
+		return &levels_[current_];
+	};
+
+	// Getter for whether a level has been requested but hasn't finished building yet.
+	bool IsLoading()
+	{
+		return level_requested_;
+	};
+
+private:
+	// Frees the spare level and builds it again, on the background thread if LEVEL_HOST_BUILD_THREAD is set.
+	void BuildNext();
+
+	// The two levels. One is played while the other is rebuilt ready for the next start or restart.
+	Level levels_[2];
+	int current_;
+	int next_;
+
+	// The thread building the next level, and whether it has finished.
+	std::thread build_thread_;
+	std::atomic<bool> next_ready_;
+
+	// The thread the level being played is simulated on.
+	WorkerThread sim_thread_;
+
+	// Watches how long the simulation and rendering take, and how long the last render took in milliseconds.
+	FrameGovernor governor_;
+	float render_time_;
+
+	// Where everything goes in the levels that are built.
+	LevelLayout layout_;
+
+	// Bool for whether a level is waiting to be swapped in.
+	bool level_requested_;
+
+	// Pointers that the levels need.
+	gef::SpriteRenderer* sprite_renderer_;
+	gef::Font* font_;
+	gef::Platform* platform_;
+	GameState* game_state_;
+	InputService* input_service_;
+	gef::AudioManager* audio_manager_;
+	MainMenu* main_menu_;
+	gef::Renderer3D* renderer_3d_;
+	PrimitiveBuilder* primitive_builder_;
+};
@@ -0,0 +1,201 @@
+#include "level_layout.h"
+
+LevelLayout::LevelLayout()
+{
+	wall_count = 0;
+}
+
+LevelLayout LevelLayout::HandPlaced()
+{
+	LevelLayout layout;
+
+	// The ground.
+	layout.AddGround(0.0f, 0.0f, 10.0f, 2.5f);
+	layout.AddGround(35.0f, 14.0f, 10.0f, 0.5f);
+	layout.AddGround(57.0f, 14.0f, 5.0f, 0.5f);
+	layout.AddGround(72.0f, 14.0f, 5.0f, 0.5f);
+	layout.AddGround(103.0f, 14.0f, 13.0f, 0.5f);
+	layout.AddGround(124.0f, 14.0f, 4.0f, 0.5f);
+	layout.AddGround(151.0f, 14.0f, 19.0f, 0.5f);
+	layout.AddGround(202.0f, 14.0f, 10.0f, 0.5f);
+	layout.AddGround(227.5f, 14.0f, 7.5f, 0.5f);
+	layout.AddGround(255.0f, 24.0f, 5.0f, 0.5f);
+
+	// The crates.
+	layout.AddCrate(0.0f, 3.0f, CrateType::WOOD);
+	layout.AddCrate(5.0f, 3.0f, CrateType::JUMP_WOOD);
+	layout.AddCrate(5.0f, 7.0f, CrateType::WOOD);
+	layout.AddCrate(9.5f, 3.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(15.0f, 7.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(20.0f, 11.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(45.5f, 14.0f, CrateType::WOOD);
+	layout.AddCrate(46.5f, 14.0f, CrateType::WOOD);
+	layout.AddCrate(47.5f, 14.0f, CrateType::WOOD);
+	layout.AddCrate(48.5f, 14.0f, CrateType::METAL);
+	layout.AddCrate(49.5f, 14.0f, CrateType::WOOD);
+	layout.AddCrate(50.5f, 14.0f, CrateType::WOOD);
+	layout.AddCrate(51.5f, 14.0f, CrateType::WOOD);
+	layout.AddCrate(70.0f, 15.0f, CrateType::WOOD);
+	layout.AddCrate(71.5f, 16.0f, CrateType::WOOD);
+	layout.AddCrate(73.5f, 19.0f, CrateType::WOOD);
+	layout.AddCrate(81.0f, 14.0f, CrateType::METAL);
+	layout.AddCrate(86.0f, 14.0f, CrateType::METAL);
+	layout.AddCrate(112.0f, 15.0f, CrateType::WOOD);
+	layout.AddCrate(135.0f, 15.0f, CrateType::JUMP_WOOD);
+	layout.AddCrate(133.0f, 19.0f, CrateType::WOOD);
+	layout.AddCrate(137.0f, 19.0f, CrateType::WOOD);
+	layout.AddCrate(168.0f, 20.0f, CrateType::WOOD);
+	layout.AddCrate(172.0f, 14.0f, CrateType::METAL);
+	layout.AddCrate(175.0f, 16.0f, CrateType::METAL);
+	layout.AddCrate(172.0f, 18.0f, CrateType::METAL);
+	layout.AddCrate(176.0f, 20.0f, CrateType::METAL);
+	layout.AddCrate(182.0f, 22.0f, CrateType::WOOD);
+	layout.AddCrate(180.0f, 14.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(181.0f, 14.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(182.0f, 14.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(187.0f, 18.0f, CrateType::METAL);
+	layout.AddCrate(209.0f, 15.0f, CrateType::JUMP_WOOD);
+	layout.AddCrate(205.5f, 20.0f, CrateType::WOOD);
+	layout.AddCrate(200.5f, 20.0f, CrateType::WOOD);
+	layout.AddCrate(216.0f, 14.0f, CrateType::METAL);
+	layout.AddCrate(240.0f, 14.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(245.0f, 19.0f, CrateType::JUMP_METAL);
+	layout.AddCrate(235.0f, 19.0f, CrateType::WOOD);
+	layout.AddCrate(240.0f, 24.0f, CrateType::WOOD);
+
+	// The enemies and their paths.
+	layout.AddEnemy(36.0f, 14.5f, 4.0f, 4.0f);
+	layout.AddEnemy(56.0f, 14.5f, 3.0f, 4.0f);
+	layout.AddEnemy(94.0f, 14.5f, 2.0f, 0.0f);
+	layout.AddEnemy(142.0f, 14.5f, 3.0f, 2.0f);
+	layout.AddEnemy(158.0f, 14.5f, 2.0f, 1.0f);
+	layout.AddEnemy(224.0f, 14.5f, 2.0f, 1.0f);
+	layout.AddEnemy(230.0f, 14.5f, 2.0f, 3.0f);
+
+	// The coins.
+	layout.AddCoin(-6.0f, 3.5f);
+	layout.AddCoin(-4.0f, 3.5f);
+	layout.AddCoin(-2.0f, 3.5f);
+	layout.AddCoin(9.5f, 4.5f);
+	layout.AddCoin(9.5f, 6.5f);
+	layout.AddCoin(9.5f, 8.5f);
+	layout.AddCoin(15.0f, 8.5f);
+	layout.AddCoin(15.0f, 10.5f);
+	layout.AddCoin(15.0f, 12.5f);
+	layout.AddCoin(20.0f, 12.5f);
+	layout.AddCoin(20.0f, 14.5f);
+	layout.AddCoin(20.0f, 16.5f);
+	layout.AddCoin(81.0f, 15.5f);
+	layout.AddCoin(86.0f, 15.5f);
+	layout.AddCoin(120.0f, 16.5f);
+	layout.AddCoin(124.0f, 16.5f);
+	layout.AddCoin(128.0f, 16.5f);
+	layout.AddCoin(135.0f, 16.5f);
+	layout.AddCoin(135.0f, 18.5f);
+	layout.AddCoin(135.0f, 20.5f);
+	layout.AddCoin(148.0f, 15.5f);
+	layout.AddCoin(151.0f, 15.5f);
+	layout.AddCoin(154.0f, 15.5f);
+	layout.AddCoin(172.0f, 15.5f);
+	layout.AddCoin(175.0f, 17.5f);
+	layout.AddCoin(172.0f, 19.5f);
+	layout.AddCoin(176.0f, 21.5f);
+	layout.AddCoin(187.0f, 19.5f);
+	layout.AddCoin(209.0f, 16.5f);
+	layout.AddCoin(209.0f, 18.5f);
+	layout.AddCoin(209.0f, 20.5f);
+	layout.AddCoin(240.0f, 15.5f);
+	layout.AddCoin(240.0f, 17.5f);
+	layout.AddCoin(240.0f, 19.5f);
+	layout.AddCoin(245.0f, 20.5f);
+	layout.AddCoin(245.0f, 22.5f);
+	layout.AddCoin(245.0f, 24.5f);
+
+	// The sawblades.
+	layout.AddSawblade(79.0f, 11.0f, 1.0f, 2.0f, 0.0f, 6.0f);
+	layout.AddSawblade(83.5f, 11.0f, 1.0f, 4.0f, 0.0f, 6.0f);
+	layout.AddSawblade(88.0f, 11.0f, 1.0f, 2.0f, 0.0f, 6.0f);
+	layout.AddSawblade(124.0f, 15.5f, 0.5f, 0.0f, 2.0f, 3.0f);
+	layout.AddSawblade(200.5f, 15.5f, 1.0f, 2.0f, 0.0f, 3.0f);
+	layout.AddSawblade(205.5f, 15.5f, 1.0f, 2.0f, 0.0f, 3.0f);
+
+	// The crushers.
+	layout.AddCrusher(100.0f, 20.0f, 0.0f, 3.0f);
+	layout.AddCrusher(104.0f, 20.0f, 3.0f, 3.0f);
+	layout.AddCrusher(108.0f, 20.0f, 0.0f, 3.0f);
+	layout.AddCrusher(148.0f, 20.0f, 0.0f, 0.5f);
+	layout.AddCrusher(151.0f, 20.0f, 0.5f, 0.5f);
+	layout.AddCrusher(154.0f, 20.0f, 1.0f, 0.5f);
+	layout.AddCrusher(203.0f, 20.0f, 0.0f, 3.0f);
+
+	// The checkpoints. The last one is the finish line.
+	layout.AddCheckpoint(68.0f, 15.0f);
+	layout.AddCheckpoint(114.0f, 15.0f);
+	layout.AddCheckpoint(168.0f, 15.0f);
+	layout.AddCheckpoint(253.0f, 25.0f);
+
+	// The background walls.
+	layout.wall_count = 31;
+
+	return layout;
+}
+
+void LevelLayout::AddGround(float x, float y, float half_width, float half_height)
+{
+	GroundPiece piece;
+	piece.position = b2Vec2(x, y);
+	piece.half_extents = b2Vec2(half_width, half_height);
+	ground.push_back(piece);
+}
+
+void LevelLayout::AddCrate(float x, float y, CrateType type)
+{
+	CratePlacement crate;
+	crate.position = b2Vec2(x, y);
+	crate.type = type;
+	crates.push_back(crate);
+}
+
+void LevelLayout::AddEnemy(float x, float y, float walk_distance, float idle_time)
+{
+	EnemyPlacement enemy;
+	enemy.position = b2Vec2(x, y);
+	enemy.walk_distance = walk_distance;
+	enemy.idle_time = idle_time;
+	enemies.push_back(enemy);
+}
+
+void LevelLayout::AddCoin(float x, float y)
+{
+	coins.push_back(b2Vec2(x, y));
+}
+
+void LevelLayout::AddSawblade(float x, float y, float half_size, float vertical_speed, float horizontal_speed, float distance)
+{
+	SawbladePlacement sawblade;
+	sawblade.position = b2Vec2(x, y);
+	sawblade.half_size = half_size;
+	sawblade.vertical_speed = vertical_speed;
+	sawblade.horizontal_speed = horizontal_speed;
+	sawblade.distance = distance;
+	sawblades.push_back(sawblade);
+}
+
+void LevelLayout::AddCrusher(float x, float y, float delay, float interval)
+{
+	CrusherPlacement crusher;
+	crusher.position = b2Vec2(x, y);
+	crusher.delay = delay;
+	crusher.interval = interval;
+	crushers.push_back(crusher);
+}
+
+void LevelLayout::AddCheckpoint(float x, float y)
+{
+	checkpoints.push_back(b2Vec2(x, y));
+}
+
+int LevelLayout::GetEntityCount() const
+{
+	return (int)(ground.size() + crates.size() + enemies.size() + coins.size() + sawblades.size() + crushers.size() + checkpoints.size());
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <box2d/Box2D.h>
+#include "crate.h"
+#include <vector>
+
+// A piece of ground, by its centre and half size.
+struct GroundPiece
+{
+	b2Vec2 position;
+	b2Vec2 half_extents;
+};
+
+// A crate and its type.
+struct CratePlacement
+{
+	b2Vec2 position;
+	CrateType type;
+};
+
+// An enemy, the distance it walks either side of its start and how long it idles at each end.
+struct EnemyPlacement
+{
+	b2Vec2 position;
+	float walk_distance;
+	float idle_time;
+};
+
+// A sawblade, its half size and how it moves.
+struct SawbladePlacement
+{
+	b2Vec2 position;
+	float half_size;
+	float vertical_speed;
+	float horizontal_speed;
+	float distance;
+};
+
+// A crusher, the delay before it first drops and the time between drops.
+struct CrusherPlacement
+{
+	b2Vec2 position;
+	float delay;
+	float interval;
+};
+
+// Where everything in a level goes. The level builds its objects from this, so the same code builds the hand-placed
+// level and generated ones.
+class LevelLayout
+{
+public:
+	LevelLayout();
+
+	// The level that ships with the game.
+	static LevelLayout HandPlaced();
+
+	// Functions for adding each kind of object.
+	void AddGround(float x, float y, float half_width, float half_height);
+	void AddCrate(float x, float y, CrateType type);
+	void AddEnemy(float x, float y, float walk_distance, float idle_time);
+	void AddCoin(float x, float y);
+	void AddSawblade(float x, float y, float half_size, float vertical_speed, float horizontal_speed, float distance);
+	void AddCrusher(float x, float y, float delay, float interval);
+	void AddCheckpoint(float x, float y);
+
+	// The total number of objects, not counting the walls.
+	int GetEntityCount() const;
+
+	// The objects in the level. The last checkpoint is the finish line.
+	std::vector<GroundPiece> ground;
+	std::vector<CratePlacement> crates;
+	std::vector<EnemyPlacement> enemies;
+	std::vector<b2Vec2> coins;
+	std::vector<SawbladePlacement> sawblades;
+	std::vector<CrusherPlacement> crushers;
+	std::vector<b2Vec2> checkpoints;
+
+	// The number of background wall panels. Half go in each row, and one more at the start stops the player walking off the left.
+	int wall_count;
+};
@@ -1,9 +1,16 @@
 #include "main_menu.h"
+#include "level_host.h"
+#include "load_texture.h"
+#include "memory_tracker.h"
 
 MainMenu::MainMenu()
 {
 	// Set default values.
 	music_playing_ = false;
+	background_texture_ = NULL;
+	title_texture_ = NULL;
+	controls_texture_ = NULL;
+	texture_bytes_ = 0;
 	debug_ = false;
 	selection_ = 0;
 	controller_ = 1;
@@ -25,10 +32,9 @@ void MainMenu::Update(float frame_time)
 	// Increase timer by frame time.
 	timer_ += frame_time;
 
-	// Process input.
+	// Process input. SceneApp has already updated the input manager this frame.
 	if (input_manager_)
 	{
-		input_manager_->Update();
 		ProcessTouchInput();
 		ProcessKeyboardInput();
 		ProcessControllerInput();
@@ -56,9 +62,8 @@ void MainMenu::Update(float frame_time)
 		switch (selection_) // Select what to do based on what button was pressed.
 		{
 		case 0:
-			// Play - switch to level state and reset the level.
-			game_state_->SetGameState(State::LEVEL);
-			level_->Reset();
+			// Play - ask for a level, the game switches to the level state once it has been built.
+			level_host_->RequestLevel();
 			break;
 		case 1:
 			// Settings - toggle settings window, make sure controls window is disabled.
@@ -195,7 +200,7 @@ void MainMenu::Render()
 	sprite_renderer_->End();
 }
 
-void MainMenu::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, Level* l)
+void MainMenu::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, LevelHost* lh)
 {
 	// Set pointers.
 	sprite_renderer_ = sr;
@@ -204,23 +209,23 @@ void MainMenu::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, Gam
 	game_state_ = gs;
 	input_manager_ = im;
 	audio_manager_ = am;
-	level_ = l;
+	level_host_ = lh;
 
 	// Load textures, assign them to sprites. Also set position and size.
-	gef::ImageData texture_image;
-	gef::PNGLoader png_loader;
-	gef::Texture* texture;
-	png_loader.Load("textures/background.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
+	// Each texture's size is added up for the memory tracker.
+	UInt32 byte_size = 0;
+	background_texture_ = LoadTexture("textures/background.png", *platform_, &byte_size);
+	texture_bytes_ += byte_size;
 
-	background_image_.set_texture(texture);
+	background_image_.set_texture(background_texture_);
 	background_image_.set_position(platform_->width() / 2, platform_->height() / 2, 0);
 	background_image_.set_width(platform_->width());
 	background_image_.set_height(platform_->height());
 
-	png_loader.Load("textures/title.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	title_.set_texture(texture);
+	byte_size = 0;
+	title_texture_ = LoadTexture("textures/title.png", *platform_, &byte_size);
+	texture_bytes_ += byte_size;
+	title_.set_texture(title_texture_);
 	title_.set_position(platform_->width() * 0.5f, platform_->height() * 0.175f, 0.0f);
 	title_.set_width(platform_->width() * 0.66);
 	title_.set_height(platform_->height() * 0.33);
@@ -229,13 +234,16 @@ void MainMenu::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, Gam
 	settings_pane_.set_width(platform_->width() / 2);
 	settings_pane_.set_height(platform_->height() / 2);
 
-	png_loader.Load("textures/controls.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-	controls_pane_.set_texture(texture);
+	byte_size = 0;
+	controls_texture_ = LoadTexture("textures/controls.png", *platform_, &byte_size);
+	texture_bytes_ += byte_size;
+	controls_pane_.set_texture(controls_texture_);
 	controls_pane_.set_position(platform_->width() * 0.6, platform_->height() * 0.6, 0);
 	controls_pane_.set_width(platform_->width() / 2);
 	controls_pane_.set_height(platform_->height() / 2);
 
+	MemoryTracker::Allocated(MEMORY_TEXTURES, texture_bytes_);
+
 	// Setup audio.
 	audio_manager_->SetMasterVolume(volume_); // start at 50% volume
 	audio_manager_->LoadMusic("audio/masters_of_the_galaxy_symphonic.wav", *platform_);
@@ -877,3 +885,17 @@ void MainMenu::Back()
 		selection_ = 0;
 	}
 }
+
+void MainMenu::CleanUp()
+{
+	// Free the textures, which the pause menu's controls pane shares.
+	delete background_texture_;
+	background_texture_ = NULL;
+	delete title_texture_;
+	title_texture_ = NULL;
+	delete controls_texture_;
+	controls_texture_ = NULL;
+
+	MemoryTracker::Freed(MEMORY_TEXTURES, texture_bytes_);
+	texture_bytes_ = 0;
+}
@@ -15,7 +15,7 @@
 #include <input/keyboard.h>
 #include "level.h"
 
-class Level;
+class LevelHost;
 
 class MainMenu
 {
@@ -25,9 +25,12 @@ public:
 	// Functions for updating, rendering, initialising and reseting the main menu.
 	void Update(float frame_time);
 	void Render();
-	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, Level* l);
+	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, LevelHost* lh);
 	void Reset();
 
+	// Frees the textures loaded by Init.
+	void CleanUp();
+
 	// Functions to retrieve the settings from the menu in the level.
 	int* GetController() {
 		return &controller_;
@@ -38,6 +41,11 @@ public:
 	int GetLives() {
 		return lives_;
 	};
+
+	// Getter for the controls texture, which the pause menu shows too.
+	gef::Texture* GetControlsTexture() {
+		return controls_texture_;
+	};
 private:
 	// Functions for processing the input.
 	void ProcessTouchInput();
@@ -69,7 +77,7 @@ private:
 	gef::InputManager* input_manager_;
 	gef::AudioManager* audio_manager_;
 	GameState* game_state_; 
-	Level* level_;
+	LevelHost* level_host_;
 
 	// For controlling the speed that the menu scrolls at.
 	float timer_;
@@ -82,6 +90,12 @@ private:
 	gef::Sprite title_;
 	gef::Sprite menu_buttons_[11];
 
+	// The textures the sprites use, and their size for the memory tracker.
+	gef::Texture* background_texture_;
+	gef::Texture* title_texture_;
+	gef::Texture* controls_texture_;
+	UInt32 texture_bytes_;
+
 	// Holds the colour of the corresponding button.
 	UInt32 button_colour_[11];
 
@@ -1,4 +1,6 @@
 #include "pause_menu.h"
+#include "level_host.h"
+#include "load_texture.h"
 
 PauseMenu::PauseMenu()
 {
@@ -21,10 +23,9 @@ void PauseMenu::Update(float frame_time)
 	// Increase timer by frame time.
 	timer_ += frame_time;
 
-	// Process input.
+	// Process input. SceneApp has already updated the input manager this frame.
 	if (input_manager_)
 	{
-		input_manager_->Update();
 		ProcessTouchInput();
 		ProcessKeyboardInput();
 		ProcessControllerInput();
@@ -55,9 +56,8 @@ void PauseMenu::Update(float frame_time)
 			game_state_->SetGameState(State::LEVEL);
 			break;
 		case 1:
-			// Restart.
-			game_state_->SetGameState(State::LEVEL);
-			level_->Reset();
+			// Restart - swap in a freshly built level.
+			level_host_->RequestLevel();
 			break;
 		case 2:
 			// Settings.
@@ -135,7 +135,7 @@ void PauseMenu::Render()
 	// Render the menu.
 	sprite_renderer_->Begin();
 
-	level_->Render(); // Render the level behind the menu.
+	level_host_->GetLevel()->Render(); // Render the level behind the menu.
 
 	// Render paused text.
 	font_->RenderText(
@@ -167,7 +167,7 @@ void PauseMenu::Render()
 	sprite_renderer_->End();
 }
 
-void PauseMenu::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, Level* l, MainMenu* mm)
+void PauseMenu::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, LevelHost* lh, MainMenu* mm)
 {
 	// Set pointers.
 	sprite_renderer_ = sr;
@@ -176,19 +176,13 @@ void PauseMenu::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, Ga
 	game_state_ = gs;
 	input_manager_ = im;
 	audio_manager_ = am;
-	level_ = l;
+	level_host_ = lh;
 	main_menu_ = mm;
 	controller_ = main_menu_->GetController();
 	volume_ = main_menu_->GetVolume();
 
-	// Load textures, assign them to sprites. Also set position and size.
-	gef::ImageData texture_image;
-	gef::PNGLoader png_loader;
-	gef::Texture* texture;
-	png_loader.Load("textures/controls.png", *platform_, texture_image);
-	texture = gef::Texture::Create(*platform_, texture_image);
-
-	controls_pane_.set_texture(texture);
+	// Share the main menu's controls texture rather than loading it again. Also set position and size.
+	controls_pane_.set_texture(main_menu_->GetControlsTexture());
 	controls_pane_.set_position(platform_->width() * 0.6, platform_->height() * 0.6, 0);
 	controls_pane_.set_width(platform_->width() / 2);
 	controls_pane_.set_height(platform_->height() / 2);
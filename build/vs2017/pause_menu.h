@@ -8,7 +8,7 @@ public:
 	// Functions for updating, rendering, and initialising the pause menu.
 	void Update(float frame_time);
 	void Render();
-	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, Level* l, MainMenu* mm);
+	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs, gef::InputManager* im, gef::AudioManager* am, LevelHost* lh, MainMenu* mm);
 private:
 	// Functions for processing the input.
 	void ProcessTouchInput();
@@ -40,7 +40,7 @@ private:
 	gef::InputManager* input_manager_;
 	gef::AudioManager* audio_manager_;
 	GameState* game_state_;
-	Level* level_;
+	LevelHost* level_host_;
 	MainMenu* main_menu_;
 
 	// For controlling the speed that the menu scrolls at.
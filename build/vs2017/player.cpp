@@ -16,6 +16,7 @@ Player::Player()
 	respawn_position_ = b2Vec2(0.0f, 0.0f);
 	death_reset_time_ = 2.0f;
 	speed_ = 5.0f;
+	arena_ = NULL;
 }
 
 void Player::Update(float frame_time)
@@ -209,48 +210,63 @@ void Player::Update(float frame_time)
 	}
 }
 
-void Player::Init(gef::Platform* p)
+void Player::Init(gef::Platform* p, LevelArena* arena)
 {
-	// Set pointer to platform.
+	// Set pointers to platform and arena.
 	platform_ = p;
+	arena_ = arena;
 
-	// Load the scene that contains the player's model.
-	player_scene_ = new gef::Scene();
-	player_scene_->ReadSceneFromFile(*platform_, "player/player.scn");
-	player_scene_->CreateMaterials(*platform_);
+	gef::Skeleton* skeleton;
 
-	// Get the player's mesh from the scene.
-	player_mesh_ = MotionClipPlayer::GetFirstMesh(player_scene_, platform_);
-	gef::Skeleton* skeleton = MotionClipPlayer::GetFirstSkeleton(player_scene_);
+	// Use the cooked model if it exists, as it doesn't need parsing.
+	CookedScene* cooked_scene = arena_->New<CookedScene>(MEMORY_MESHES);
+	if (cooked_scene->Load("player/player.scnb", *platform_))
+	{
+		arena_->Track(MEMORY_MESHES, cooked_scene->mesh_bytes());
+		arena_->Track(MEMORY_TEXTURES, cooked_scene->texture_bytes());
+		player_mesh_ = cooked_scene->mesh();
+		skeleton = cooked_scene->skeleton();
+	}
+	else
+	{
+		// Load the scene that contains the player's model. Its size is estimated from the file.
+		gef::Scene* player_scene = arena_->Adopt(new gef::Scene(), MEMORY_MESHES, AssetBlob::FileSize("player/player.scn"));
+		player_scene->ReadSceneFromFile(*platform_, "player/player.scn");
+		player_scene->CreateMaterials(*platform_);
+
+		// Get the player's mesh from the scene.
+		player_mesh_ = MotionClipPlayer::GetFirstMesh(player_scene, platform_);
+		skeleton = MotionClipPlayer::GetFirstSkeleton(player_scene);
+	}
 
 	// Setup the animated mesh.
 	if (skeleton)
 	{
-		animated_mesh_ = new gef::SkinnedMeshInstance(*skeleton);
+		animated_mesh_ = arena_->New<gef::SkinnedMeshInstance>(MEMORY_ANIMATION, *skeleton);
 		anim_player_.Init(animated_mesh_->bind_pose());
 		animated_mesh_->set_mesh(player_mesh_);
 	}
 
 	// Load all of the animations.
-	kick_anim_ = MotionClipPlayer::LoadAnimation("player/anim-kick.scn", "", platform_);
-	idle_anim_ = MotionClipPlayer::LoadAnimation("player/anim-idle.scn", "", platform_);
-	jump_anim_ = MotionClipPlayer::LoadAnimation("player/anim-jump.scn", "", platform_);
-	fall_anim_ = MotionClipPlayer::LoadAnimation("player/anim-fall.scn", "", platform_);
-	land_anim_ = MotionClipPlayer::LoadAnimation("player/anim-land.scn", "", platform_);
-	run_anim_ = MotionClipPlayer::LoadAnimation("player/anim-run.scn", "", platform_);
-	death_anim_ = MotionClipPlayer::LoadAnimation("player/anim-death.scn", "", platform_);
-	dance_anim_ = MotionClipPlayer::LoadAnimation("player/anim-dance.scn", "", platform_);
+	kick_anim_ = LoadAnim("player/anim-kick.scn");
+	idle_anim_ = LoadAnim("player/anim-idle.scn");
+	jump_anim_ = LoadAnim("player/anim-jump.scn");
+	fall_anim_ = LoadAnim("player/anim-fall.scn");
+	land_anim_ = LoadAnim("player/anim-land.scn");
+	run_anim_ = LoadAnim("player/anim-run.scn");
+	death_anim_ = LoadAnim("player/anim-death.scn");
+	dance_anim_ = LoadAnim("player/anim-dance.scn");
 
 	// Set initial transform of the animated mesh.
 	animated_mesh_->set_transform(this->transform());
 }
 
-void Player::Render(gef::Renderer3D* renderer_3d)
+void Player::Render(RenderQueue* render_queue)
 {
-	// Render the animated mesh.
+	// Queue the animated mesh. It uses the model's own materials.
 	if (animated_mesh_)
 	{
-		renderer_3d->DrawSkinnedMesh(*animated_mesh_, animated_mesh_->bone_matrices(), true);
+		render_queue->AddSkinnedMesh(PASS_SKINNED, NULL, animated_mesh_);
 	}
 }
 
@@ -307,5 +323,9 @@ void Player::SetDead()
 	SetState(PlayerState::DEAD);
 }
 
-
-
+AnimClip* Player::LoadAnim(const char* anim_scene_filename)
+{
+	// Load the animation and hand it to the arena, so it's freed with the level.
+	AnimClip* clip = MotionClipPlayer::LoadAnimation(anim_scene_filename, "", platform_);
+	return arena_->Adopt(clip, MEMORY_ANIMATION, clip ? clip->memory_size() : 0);
+}
@@ -4,6 +4,9 @@
 #include <animation/animation.h>
 #include <graphics/scene.h>
 #include "motion_clip_player.h"
+#include "cooked_scene.h"
+#include "level_arena.h"
+#include "render_queue.h"
 #include "graphics/renderer_3d.h"
 #include "maths/math_utils.h"
 
@@ -26,8 +29,8 @@ public:
 	
 	// Functions for updating, initialising and rendering the player.
 	void Update(float frame_time);
-	void Init(gef::Platform* p);
-	void Render(gef::Renderer3D* renderer_3d);
+	void Init(gef::Platform* p, LevelArena* arena);
+	void Render(RenderQueue* render_queue);
 
 	// Functions for player movement and actions.
 	void Jump();
@@ -106,19 +109,24 @@ private:
 	// The speed the player will travel at.
 	float speed_;
 
+	// Loads an animation into the level's arena.
+	AnimClip* LoadAnim(const char* anim_scene_filename);
+
+	// The arena the player's model and animations are created in.
+	LevelArena* arena_;
+
 	// For holding and creating the player's animated mesh.
 	gef::Mesh* player_mesh_;
 	gef::SkinnedMeshInstance* animated_mesh_;
-	gef::Scene* player_scene_;
 
 	// The player's animations and animation player.
-	gef::Animation* kick_anim_;
-	gef::Animation* idle_anim_;
-	gef::Animation* jump_anim_;
-	gef::Animation* fall_anim_;
-	gef::Animation* land_anim_;
-	gef::Animation* run_anim_;
-	gef::Animation* death_anim_;
-	gef::Animation* dance_anim_;
+	AnimClip* kick_anim_;
+	AnimClip* idle_anim_;
+	AnimClip* jump_anim_;
+	AnimClip* fall_anim_;
+	AnimClip* land_anim_;
+	AnimClip* run_anim_;
+	AnimClip* death_anim_;
+	AnimClip* dance_anim_;
 	MotionClipPlayer anim_player_;
 };
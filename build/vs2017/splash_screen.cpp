@@ -1,10 +1,14 @@
 #include "splash_screen.h"
+#include "load_texture.h"
+#include "memory_tracker.h"
 
 // Constructor
 SplashScreen::SplashScreen()
 {
 	timer_ = 0.0f;
 	splash_time_ = 2.0f; // The splash screen will last for 2 seconds.
+	splash_texture_ = NULL;
+	texture_bytes_ = 0;
 }
 
 void SplashScreen::Update(float frame_time)
@@ -36,13 +40,21 @@ void SplashScreen::Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p,
 	game_state_ = gs;
 
 	// Create a texture for the splash image and assign it to the sprite.
-	gef::ImageData texture_image;
-	gef::PNGLoader png_loader;
-	png_loader.Load("textures/splash.png", *platform_, texture_image);
-	gef::Texture* texture = gef::Texture::Create(*platform_, texture_image);
+	splash_texture_ = LoadTexture("textures/splash.png", *platform_, &texture_bytes_);
+	MemoryTracker::Allocated(MEMORY_TEXTURES, texture_bytes_);
 
-	splash_image_.set_texture(texture);
+	splash_image_.set_texture(splash_texture_);
 	splash_image_.set_position(platform_->width() / 2, platform_->height() / 2, 0);
 	splash_image_.set_width(platform_->width());
 	splash_image_.set_height(platform_->height());
 }
+
+void SplashScreen::CleanUp()
+{
+	// Free the splash image's texture.
+	delete splash_texture_;
+	splash_texture_ = NULL;
+
+	MemoryTracker::Freed(MEMORY_TEXTURES, texture_bytes_);
+	texture_bytes_ = 0;
+}
@@ -18,6 +18,9 @@ public:
 	void Update(float frame_time);
 	void Render();
 	void Init(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, GameState* gs);
+
+	// Frees the textures loaded by Init.
+	void CleanUp();
 private:
 	// Required pointers for the splash screen.
 	gef::SpriteRenderer* sprite_renderer_;
@@ -31,5 +34,9 @@ private:
 
 	// Sprite to store the splash screen's image.
 	gef::Sprite splash_image_;
+
+	// The splash image's texture, and its size for the memory tracker.
+	gef::Texture* splash_texture_;
+	UInt32 texture_bytes_;
 };
 
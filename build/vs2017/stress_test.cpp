@@ -0,0 +1,153 @@
+#include "stress_test.h"
+#include "level.h"
+#include "level_generator.h"
+#include "memory_tracker.h"
+#include <system/debug_log.h>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+	// The same seed every run, so results can be compared between builds.
+	const UInt32 kSeed = 1234;
+
+	// Each scale multiplies the entity count of the hand-placed level.
+	const int kScales[] = { 1, 10, 100, 1000 };
+
+	// Frames played at each scale, at a fixed 60Hz step.
+	const int kFrameCount = 600;
+	const float kFrameTime = 1.0f / 60.0f;
+
+	// Stop a scale early if it takes longer than this, so a very slow scale doesn't hang the test.
+	const float kTimeLimit = 60.0f;
+
+	// How often the scripted player jumps and attacks, in frames.
+	const int kJumpInterval = 45;
+	const int kAttackInterval = 90;
+
+	// Milliseconds between two points in time.
+	typedef std::chrono::high_resolution_clock Clock;
+	float Milliseconds(Clock::time_point start, Clock::time_point end)
+	{
+		return std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	// Sends a key event to the level, as the input thread would.
+	void SendKey(Level* level, INPUT_EVENT_TYPE type, gef::Keyboard::KeyCode key)
+	{
+		InputEvent event;
+		event.time = 0;
+		event.type = type;
+		event.code = key;
+		event.x = 0.0f;
+		event.y = 0.0f;
+		level->ApplyInput(event);
+	}
+}
+
+void StressTest::Run(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb)
+{
+	gef::DebugOut("Stress test: %d frames per scale, seed %u\n", kFrameCount, kSeed);
+	gef::DebugOut("scale entities frames  frame avg/max ms  update ms  step ms  render ms  memory KB  proxies  pairs  touching\n");
+
+	for (int scale_num = 0; scale_num < (int)(sizeof(kScales) / sizeof(kScales[0])); scale_num++)
+	{
+		int scale = kScales[scale_num];
+
+		// Grow the level in both length and density, so neither gets extreme. Lengths stay short enough for box2d's
+		// float positions to be accurate at the far end.
+		float growth = sqrtf((float)scale);
+		LevelGenerator generator(kSeed);
+		LevelLayout layout = generator.Generate(256.0f * growth, growth);
+
+		// The level gets its own game state, so winning or losing doesn't change the game's.
+		// There is no input service, the scripted player sends its input straight to the level.
+		GameState game_state;
+		game_state.SetGameState(State::LEVEL);
+		Level* level = new Level();
+		level->Init(sr, f, p, &game_state, NULL, am, mm, r3d, pb, layout);
+		level->Reset();
+
+		float total_frame = 0.0f;
+		float max_frame = 0.0f;
+		float total_update = 0.0f;
+		float total_step = 0.0f;
+		float total_render = 0.0f;
+		int max_proxies = 0;
+		int max_pairs = 0;
+		int max_touching = 0;
+		size_t peak_memory = MemoryTracker::total_current_bytes();
+
+		// The scripted player holds right, jumps every so often and straight away if it stops moving forward.
+		SendKey(level, INPUT_KEY_DOWN, gef::Keyboard::KC_D);
+		float last_x = level->GetPlayerPosition().x;
+
+		Clock::time_point scale_start = Clock::now();
+		int frame = 0;
+		for (; frame < kFrameCount; frame++)
+		{
+			float x = level->GetPlayerPosition().x;
+			if (frame % kJumpInterval == 0 || x - last_x < 0.01f)
+			{
+				SendKey(level, INPUT_KEY_DOWN, gef::Keyboard::KC_SPACE);
+				SendKey(level, INPUT_KEY_UP, gef::Keyboard::KC_SPACE);
+			}
+			if (frame % kAttackInterval == 0)
+			{
+				SendKey(level, INPUT_KEY_DOWN, gef::Keyboard::KC_F);
+				SendKey(level, INPUT_KEY_UP, gef::Keyboard::KC_F);
+			}
+			last_x = x;
+
+			// Update and render one after the other, so each can be timed on its own.
+			// Render only covers submitting the draws, the frame isn't presented.
+			Clock::time_point frame_start = Clock::now();
+			level->Update(kFrameTime);
+			Clock::time_point update_end = Clock::now();
+			level->Render();
+			Clock::time_point render_end = Clock::now();
+
+			float update_time = Milliseconds(frame_start, update_end);
+			float render_time = Milliseconds(update_end, render_end);
+			float frame_time = update_time + render_time;
+			total_frame += frame_time;
+			total_update += update_time;
+			total_render += render_time;
+			total_step += level->GetStepTime();
+			if (frame_time > max_frame)
+				max_frame = frame_time;
+
+			if (level->GetProxyCount() > max_proxies)
+				max_proxies = level->GetProxyCount();
+			if (level->GetPairCount() > max_pairs)
+				max_pairs = level->GetPairCount();
+			if (level->GetTouchingCount() > max_touching)
+				max_touching = level->GetTouchingCount();
+			if (MemoryTracker::total_current_bytes() > peak_memory)
+				peak_memory = MemoryTracker::total_current_bytes();
+
+			if (Milliseconds(scale_start, Clock::now()) > kTimeLimit * 1000.0f)
+			{
+				frame++;
+				break;
+			}
+		}
+
+		float frames = (float)(frame > 0 ? frame : 1);
+		gef::DebugOut("%5dx %8d %6d  %7.3f/%-8.3f  %9.3f  %7.3f  %9.3f  %9u  %7d  %5d  %8d\n",
+			scale, layout.GetEntityCount(), frame,
+			total_frame / frames, max_frame, total_update / frames, total_step / frames, total_render / frames,
+			(unsigned)(peak_memory / 1024), max_proxies, max_pairs, max_touching);
+
+		// Break the memory down by subsystem while the level still holds it.
+		for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++)
+		{
+			gef::DebugOut("       %-10s %9u KB\n", MemoryTracker::TagName((MEMORY_TAG)tag), (unsigned)(MemoryTracker::current_bytes((MEMORY_TAG)tag) / 1024));
+		}
+
+		// Stop the level's music and free it before building the next scale.
+		am->StopMusic();
+		level->CleanUp();
+		delete level;
+	}
+}
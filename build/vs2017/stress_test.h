@@ -0,0 +1,20 @@
+#pragma once
+#include "gef.h"
+#include "graphics/sprite_renderer.h"
+#include "graphics/font.h"
+#include "system/platform.h"
+#include "audio/audio_manager.h"
+#include "graphics/renderer_3d.h"
+#include <primitive_builder.h>
+
+class MainMenu;
+
+// Plays generated levels at 1x, 10x, 100x and 1000x the hand-placed level's entity count with a scripted player,
+// and writes the frame time, physics step time, memory use and contact counts for each to the debug output.
+// Built into the game when STRESS_TEST is defined, like the asset cooker.
+class StressTest
+{
+public:
+	// Runs every scale in turn. Each level is built, played and freed before the next, so they don't share memory.
+	static void Run(gef::SpriteRenderer* sr, gef::Font* f, gef::Platform* p, gef::AudioManager* am, MainMenu* mm, gef::Renderer3D* r3d, PrimitiveBuilder* pb);
+};
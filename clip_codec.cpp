@@ -0,0 +1,160 @@
+#include "clip_codec.h"
+#include <cmath>
+
+namespace
+{
+	// The three smallest components of a unit quaternion are within +-1/sqrt(2).
+	const float kSmallestThreeRange = 0.70710678f;
+	const float kSmallestThreeSteps = 32767.0f;
+}
+
+void QuantiseRotation(const gef::Quaternion& rotation, UInt16* quantised)
+{
+	float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+	UInt32 largest = 0;
+	for (UInt32 component = 1; component < 4; ++component)
+	{
+		if (fabsf(components[component]) > fabsf(components[largest]))
+			largest = component;
+	}
+
+	// q and -q are the same rotation, so flip it to make the dropped component positive
+	float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+	UInt32 value_num = 0;
+	for (UInt32 component = 0; component < 4; ++component)
+	{
+		if (component == largest)
+			continue;
+
+		float value = components[component] * sign / kSmallestThreeRange;
+		value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+		UInt16 steps = (UInt16)floorf((value * 0.5f + 0.5f) * kSmallestThreeSteps + 0.5f);
+		quantised[value_num++] = (UInt16)(steps << 1);
+	}
+
+	quantised[0] |= (UInt16)(largest >> 1);
+	quantised[1] |= (UInt16)(largest & 1);
+}
+
+gef::Quaternion DequantiseRotation(const UInt16* quantised)
+{
+	UInt32 largest = ((quantised[0] & 1) << 1) | (quantised[1] & 1);
+
+	float components[4];
+	float sum = 0.0f;
+	UInt32 value_num = 0;
+	for (UInt32 component = 0; component < 4; ++component)
+	{
+		if (component == largest)
+			continue;
+
+		float value = ((quantised[value_num++] >> 1) / kSmallestThreeSteps * 2.0f - 1.0f) * kSmallestThreeRange;
+		components[component] = value;
+		sum += value * value;
+	}
+	components[largest] = sqrtf(sum < 1.0f ? 1.0f - sum : 0.0f);
+
+	return gef::Quaternion(components[0], components[1], components[2], components[3]);
+}
+
+UInt16 QuantiseClipTime(float time, float start_time, float duration)
+{
+	float fraction = duration > 0.0f ? (time - start_time) / duration : 0.0f;
+	fraction = fraction < 0.0f ? 0.0f : (fraction > 1.0f ? 1.0f : fraction);
+	return (UInt16)floorf(fraction * kClipTimeSteps + 0.5f);
+}
+
+ClipDecoder::ClipDecoder(const ClipInfo& info, const TrackDesc* tracks, const UInt32* blocks, UInt32 block_count, const UInt16* keys) :
+	info_(info),
+	tracks_(tracks),
+	blocks_(blocks),
+	block_count_(block_count),
+	keys_(keys),
+	time_(0.0f),
+	cursor_(keys),
+	cursor_track_(0)
+{
+}
+
+void ClipDecoder::Seek(float time)
+{
+	float clip_time = time - info_.start_time;
+	clip_time = clip_time < 0.0f ? 0.0f : (clip_time > info_.duration ? info_.duration : clip_time);
+	time_ = info_.duration > 0.0f ? clip_time / info_.duration * kClipTimeSteps : 0.0f;
+
+	UInt32 block = info_.block_duration > 0.0f ? (UInt32)(clip_time / info_.block_duration) : 0;
+	if (block >= block_count_)
+		block = block_count_ > 0 ? block_count_ - 1 : 0;
+
+	cursor_ = block_count_ > 0 ? keys_ + blocks_[block] : keys_;
+	cursor_track_ = 0;
+}
+
+const UInt16* ClipDecoder::FindKeys(UInt32 block_track, UInt32& key, UInt32& next_key, float& blend)
+{
+	// skip the tracks before this one, each is its count, times and values
+	while (cursor_track_ < block_track)
+	{
+		cursor_ += 1 + cursor_[0] * 4;
+		++cursor_track_;
+	}
+
+	UInt32 count = cursor_[0];
+	const UInt16* times = cursor_ + 1;
+
+	// blocks only hold a few keys per track, so a linear search is quicker than a binary one
+	key = 0;
+	while (key + 1 < count && times[key + 1] <= time_)
+		++key;
+	next_key = key + 1 < count ? key + 1 : key;
+
+	blend = 0.0f;
+	if (times[next_key] > times[key])
+	{
+		blend = (time_ - times[key]) / (float)(times[next_key] - times[key]);
+		blend = blend < 0.0f ? 0.0f : (blend > 1.0f ? 1.0f : blend);
+	}
+
+	return times + count;
+}
+
+gef::Quaternion ClipDecoder::ReadRotation(UInt16 track)
+{
+	const TrackDesc& desc = tracks_[track];
+	if (desc.block_track == kConstantTrack)
+		return gef::Quaternion(desc.base[0], desc.base[1], desc.base[2], desc.base[3]);
+
+	UInt32 key, next_key;
+	float blend;
+	const UInt16* values = FindKeys(desc.block_track, key, next_key, blend);
+
+	// quantising can flip a key's sign, so make sure the two keys are on the same side to take the short way round
+	gef::Quaternion a = DequantiseRotation(values + key * 3);
+	gef::Quaternion b = DequantiseRotation(values + next_key * 3);
+	if (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f)
+		b = gef::Quaternion(-b.x, -b.y, -b.z, -b.w);
+
+	gef::Quaternion rotation;
+	rotation.Slerp(a, b, blend);
+	return rotation;
+}
+
+gef::Vector4 ClipDecoder::ReadVector(UInt16 track)
+{
+	const TrackDesc& desc = tracks_[track];
+	if (desc.block_track == kConstantTrack)
+		return gef::Vector4(desc.base[0], desc.base[1], desc.base[2]);
+
+	UInt32 key, next_key;
+	float blend;
+	const UInt16* values = FindKeys(desc.block_track, key, next_key, blend);
+	const UInt16* a = values + key * 3;
+	const UInt16* b = values + next_key * 3;
+
+	return gef::Vector4(
+		desc.base[0] + (a[0] + (b[0] - a[0]) * blend) * desc.step[0],
+		desc.base[1] + (a[1] + (b[1] - a[1]) * blend) * desc.step[1],
+		desc.base[2] + (a[2] + (b[2] - a[2]) * blend) * desc.step[2]);
+}
@@ -0,0 +1,71 @@
+#ifndef _CLIP_CODEC_H
+#define _CLIP_CODEC_H
+
+#include "asset_blob.h"
+#include <maths/quaternion.h>
+#include <maths/vector4.h>
+
+// A channel's track index when the joint doesn't have that track.
+static const UInt16 kNoTrack = 0xffff;
+
+// A track's block_track when it has a single value rather than keys.
+static const UInt32 kConstantTrack = 0xffffffff;
+
+// Key times are stored as a fraction of the clip's duration in this many steps.
+static const float kClipTimeSteps = 65535.0f;
+
+// The length of a block of keys. Shorter blocks read less memory per sample but repeat more keys at their edges.
+static const float kClipBlockDuration = 0.5f;
+
+/// @brief Quantise a unit quaternion to 48 bits. The largest component is dropped, as it can be rebuilt from the other
+/// three, and the other three are stored in 15 bits each. The 2 bit index of the dropped component is held in the low
+/// bit of the first two values.
+void QuantiseRotation(const gef::Quaternion& rotation, UInt16* quantised);
+
+/// @brief Rebuild a quaternion quantised by QuantiseRotation.
+gef::Quaternion DequantiseRotation(const UInt16* quantised);
+
+/// @brief Quantise a clip time to the steps used by key times.
+UInt16 QuantiseClipTime(float time, float start_time, float duration);
+
+// Samples a compressed clip in place.
+// Each block holds, for each keyed track in order: the key count, the key times, then three values per key.
+// Seek to a time, then read the tracks in increasing order, so each block is read from start to end.
+class ClipDecoder
+{
+public:
+	/// @param[in] info			The clip's info section.
+	/// @param[in] tracks		The tracks section.
+	/// @param[in] blocks		The blocks section, the offset of each block in the keys section.
+	/// @param[in] block_count	The number of blocks.
+	/// @param[in] keys			The keys section.
+	ClipDecoder(const ClipInfo& info, const TrackDesc* tracks, const UInt32* blocks, UInt32 block_count, const UInt16* keys);
+
+	/// @brief Move to the block containing a time. Tracks can then be read in increasing order.
+	/// @param[in] time		The time to sample the clip at, including the start time.
+	void Seek(float time);
+
+	/// @brief Read a rotation track at the time passed to Seek.
+	gef::Quaternion ReadRotation(UInt16 track);
+
+	/// @brief Read a translation or scale track at the time passed to Seek.
+	gef::Vector4 ReadVector(UInt16 track);
+
+private:
+	// Move to a keyed track in the current block, and find the keys either side of the seek time.
+	// Returns the track's first value.
+	const UInt16* FindKeys(UInt32 block_track, UInt32& key, UInt32& next_key, float& blend);
+
+	const ClipInfo& info_;
+	const TrackDesc* tracks_;
+	const UInt32* blocks_;
+	UInt32 block_count_;
+	const UInt16* keys_;
+
+	// The seek time in key time steps, and how far through the current block has been read.
+	float time_;
+	const UInt16* cursor_;
+	UInt32 cursor_track_;
+};
+
+#endif // _CLIP_CODEC_H
@@ -0,0 +1,75 @@
+#include "collision_filter.h"
+
+namespace
+{
+	// The pairs of object types that interact. Any pair not listed never creates a contact.
+	// Each pair is listed once, the masks are built from it so the matrix is always symmetric.
+	const OBJECT_TYPE kCollisionPairs[][2] =
+	{
+		// the player touches everything that affects it
+		{ PLAYER, GROUND },
+		{ PLAYER, WALL },
+		{ PLAYER, ENEMY },
+		{ PLAYER, CRATE },
+		{ PLAYER, COIN },
+		{ PLAYER, CHECKPOINT },
+		{ PLAYER, SAWBLADE },
+		{ PLAYER, CRUSHER },
+
+		// enemies walk on the level and bump into each other
+		{ ENEMY, GROUND },
+		{ ENEMY, WALL },
+		{ ENEMY, CRATE },
+		{ ENEMY, CRUSHER },
+		{ ENEMY, ENEMY },
+
+		// crushers clang when they reach the ground
+		{ CRUSHER, GROUND },
+
+		// coins released from crates bounce off the level and each other
+		{ COIN, GROUND },
+		{ COIN, WALL },
+		{ COIN, CRATE },
+		{ COIN, COIN },
+
+		// checkpoints and sawblades only interact with the player
+	};
+
+	struct CollisionMasks
+	{
+		CollisionMasks()
+		{
+			for (int type = 0; type <= NONE; ++type)
+				masks[type] = 0;
+
+			for (size_t pair_num = 0; pair_num < sizeof(kCollisionPairs) / sizeof(kCollisionPairs[0]); ++pair_num)
+			{
+				OBJECT_TYPE a = kCollisionPairs[pair_num][0];
+				OBJECT_TYPE b = kCollisionPairs[pair_num][1];
+				masks[a] |= CollisionCategory(b);
+				masks[b] |= CollisionCategory(a);
+			}
+		}
+
+		uint16 masks[NONE + 1];
+	};
+}
+
+uint16 CollisionCategory(OBJECT_TYPE type)
+{
+	// one bit per type, objects without a type aren't in the matrix
+	if (type == NONE)
+		return 0;
+	return (uint16)(1 << type);
+}
+
+b2Filter CollisionFilter(OBJECT_TYPE type)
+{
+	static const CollisionMasks collision_masks;
+
+	// objects without a type aren't in the matrix, so get no category and collide with nothing
+	b2Filter filter;
+	filter.categoryBits = CollisionCategory(type);
+	filter.maskBits = collision_masks.masks[type];
+	return filter;
+}
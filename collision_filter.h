@@ -0,0 +1,14 @@
+#ifndef _COLLISION_FILTER_H
+#define _COLLISION_FILTER_H
+
+#include "game_object.h"
+
+/// @brief Get the collision category bit for a type of game object.
+/// @return The category bit, or 0 for types that aren't in the collision matrix.
+uint16 CollisionCategory(OBJECT_TYPE type);
+
+/// @brief Get the Box2D filter for a type of game object, so it only generates contacts with the types it interacts with.
+/// @return The filter, with the type's category bit and a mask of every type it can collide with.
+b2Filter CollisionFilter(OBJECT_TYPE type);
+
+#endif // _COLLISION_FILTER_H
@@ -0,0 +1,128 @@
+#include "cooked_scene.h"
+#include "load_texture.h"
+#include <graphics/mesh.h>
+#include <graphics/primitive.h>
+#include <graphics/material.h>
+#include <graphics/texture.h>
+#include <animation/skeleton.h>
+#include <system/platform.h>
+#include <cstring>
+
+CookedScene::CookedScene() :
+	mesh_(NULL),
+	skeleton_(NULL),
+	mesh_bytes_(0),
+	texture_bytes_(0)
+{
+}
+
+CookedScene::~CookedScene()
+{
+	CleanUp();
+}
+
+bool CookedScene::Load(const char* blob_filename, gef::Platform& platform)
+{
+	CleanUp();
+
+	// the blob is only needed while the gpu buffers are created from it
+	AssetBlob blob;
+	if (!blob.Load(blob_filename) || blob.type() != BLOB_SCENE)
+		return false;
+
+	const MeshInfo* mesh_info = static_cast<const MeshInfo*>(blob.FindSection(SECTION_MESH_INFO));
+	const void* vertices = blob.FindSection(SECTION_VERTICES);
+	if (!mesh_info || !vertices)
+		return false;
+
+	// materials
+	UInt32 material_count = 0;
+	const MaterialDesc* material_descs = static_cast<const MaterialDesc*>(blob.FindSection(SECTION_MATERIALS, &material_count));
+	for (UInt32 material_num = 0; material_num < material_count; ++material_num)
+	{
+		gef::Material* material = new gef::Material();
+		material->set_colour(material_descs[material_num].colour);
+
+		if (material_descs[material_num].diffuse_texture[0] != '\0')
+		{
+			UInt32 texture_size = 0;
+			gef::Texture* texture = LoadTexture(material_descs[material_num].diffuse_texture, platform, &texture_size);
+			if (texture)
+			{
+				material->set_texture(texture);
+				textures_.push_back(texture);
+				texture_bytes_ += texture_size;
+			}
+		}
+
+		materials_.push_back(material);
+	}
+
+	// mesh, the vertex and index buffers are uploaded straight from the blob
+	mesh_ = gef::Mesh::Create(platform);
+	mesh_->InitVertexBuffer(platform, vertices, mesh_info->num_vertices, mesh_info->vertex_byte_size);
+	mesh_bytes_ += mesh_info->num_vertices * mesh_info->vertex_byte_size;
+
+	UInt32 primitive_count = 0;
+	const PrimitiveDesc* primitive_descs = static_cast<const PrimitiveDesc*>(blob.FindSection(SECTION_PRIMITIVES, &primitive_count));
+	const UInt8* indices = static_cast<const UInt8*>(blob.FindSection(SECTION_INDICES));
+	if (primitive_descs && indices)
+	{
+		mesh_->AllocatePrimitives(primitive_count);
+		for (UInt32 primitive_num = 0; primitive_num < primitive_count; ++primitive_num)
+		{
+			const PrimitiveDesc& primitive_desc = primitive_descs[primitive_num];
+
+			gef::Primitive* primitive = mesh_->GetPrimitive(primitive_num);
+			primitive->InitIndexBuffer(platform, indices + primitive_desc.index_offset, primitive_desc.num_indices, primitive_desc.index_byte_size);
+			primitive->set_type((gef::PrimitiveType)primitive_desc.type);
+			mesh_bytes_ += primitive_desc.num_indices * primitive_desc.index_byte_size;
+
+			if (primitive_desc.material_index >= 0 && primitive_desc.material_index < (Int32)materials_.size())
+				primitive->set_material(materials_[primitive_desc.material_index]);
+		}
+	}
+
+	gef::Aabb aabb(gef::Vector4(mesh_info->aabb_min[0], mesh_info->aabb_min[1], mesh_info->aabb_min[2]),
+		gef::Vector4(mesh_info->aabb_max[0], mesh_info->aabb_max[1], mesh_info->aabb_max[2]));
+	mesh_->set_aabb(aabb);
+	mesh_->set_bounding_sphere(gef::Sphere(aabb));
+
+	// skeleton
+	UInt32 joint_count = 0;
+	const JointDesc* joint_descs = static_cast<const JointDesc*>(blob.FindSection(SECTION_JOINTS, &joint_count));
+	if (joint_descs)
+	{
+		skeleton_ = new gef::Skeleton();
+		for (UInt32 joint_num = 0; joint_num < joint_count; ++joint_num)
+		{
+			gef::Joint joint;
+			joint.name_id = joint_descs[joint_num].name_id;
+			joint.parent = joint_descs[joint_num].parent;
+			memcpy(&joint.inv_bind_pose, joint_descs[joint_num].inv_bind_pose, sizeof(joint_descs[joint_num].inv_bind_pose));
+			skeleton_->AddJoint(joint);
+		}
+	}
+
+	return true;
+}
+
+void CookedScene::CleanUp()
+{
+	delete mesh_;
+	mesh_ = NULL;
+
+	delete skeleton_;
+	skeleton_ = NULL;
+
+	for (size_t i = 0; i < materials_.size(); ++i)
+		delete materials_[i];
+	materials_.clear();
+
+	for (size_t i = 0; i < textures_.size(); ++i)
+		delete textures_[i];
+	textures_.clear();
+
+	mesh_bytes_ = 0;
+	texture_bytes_ = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef _COOKED_SCENE_H
+#define _COOKED_SCENE_H
+
+#include "asset_blob.h"
+#include <vector>
+
+namespace gef
+{
+	class Mesh;
+	class Skeleton;
+	class Material;
+	class Texture;
+	class Platform;
+}
+
+// A mesh, its materials and skeleton created from a cooked scene blob.
+// Takes the place of a gef::Scene for models that only need their first mesh and skeleton.
+class CookedScene
+{
+public:
+	CookedScene();
+	~CookedScene();
+
+	/// @brief Create the mesh, materials and skeleton from a cooked scene blob.
+	/// @return true if the blob was loaded and contained a mesh.
+	/// @param[in] blob_filename	The cooked scene to load.
+	/// @param[in] platform			The platform the mesh is being created on.
+	bool Load(const char* blob_filename, gef::Platform& platform);
+
+	/// @brief Free everything created by Load.
+	void CleanUp();
+
+	gef::Mesh* mesh() const { return mesh_; }
+	gef::Skeleton* skeleton() const { return skeleton_; }
+
+	/// @brief The memory held by the mesh buffers and textures.
+	size_t mesh_bytes() const { return mesh_bytes_; }
+	size_t texture_bytes() const { return texture_bytes_; }
+
+private:
+	gef::Mesh* mesh_;
+	gef::Skeleton* skeleton_;
+	std::vector<gef::Material*> materials_;
+	std::vector<gef::Texture*> textures_;
+	size_t mesh_bytes_;
+	size_t texture_bytes_;
+};
+
+#endif // _COOKED_SCENE_H
@@ -0,0 +1,144 @@
+#include "frame_governor.h"
+#include <system/debug_log.h>
+
+namespace
+{
+	// How much each new frame moves the average, about a tenth of a second at 60Hz.
+	const float kAverageWeight = 0.15f;
+
+	// Step down after this many frames over the budget, step up after this many well under it.
+	const float kStepDownLoad = 0.9f;
+	const float kStepUpLoad = 0.6f;
+	const UInt32 kStepDownFrames = 10;
+	const UInt32 kStepUpFrames = 120;
+
+	// Frames to wait after a change, so its effect shows in the averages before deciding again.
+	const UInt32 kSettleFrames = 30;
+}
+
+FrameGovernor::FrameGovernor(float budget) :
+	budget_(budget),
+	has_times_(false),
+	over_frames_(0),
+	under_frames_(0),
+	settle_frames_(0),
+	tier_(QUALITY_HIGH)
+{
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+		phase_times_[phase] = 0.0f;
+
+	// everything, poses at 30Hz
+	QualitySettings& high = settings_[QUALITY_HIGH];
+	high.anim_time_step = 1.0f / 30.0f;
+	high.particle_fraction = 1.0f;
+	high.max_voices = 16;
+	high.optional_sounds = true;
+	high.far_actor_distance = 0.0f;
+	high.far_actor_interval = 1;
+
+	// actors off the side of the screen animate at half rate
+	QualitySettings& medium = settings_[QUALITY_MEDIUM];
+	medium.anim_time_step = 1.0f / 30.0f;
+	medium.particle_fraction = 0.75f;
+	medium.max_voices = 10;
+	medium.optional_sounds = true;
+	medium.far_actor_distance = 25.0f;
+	medium.far_actor_interval = 2;
+
+	QualitySettings& low = settings_[QUALITY_LOW];
+	low.anim_time_step = 1.0f / 20.0f;
+	low.particle_fraction = 0.5f;
+	low.max_voices = 6;
+	low.optional_sounds = false;
+	low.far_actor_distance = 20.0f;
+	low.far_actor_interval = 3;
+
+	QualitySettings& lowest = settings_[QUALITY_LOWEST];
+	lowest.anim_time_step = 1.0f / 15.0f;
+	lowest.particle_fraction = 0.25f;
+	lowest.max_voices = 4;
+	lowest.optional_sounds = false;
+	lowest.far_actor_distance = 15.0f;
+	lowest.far_actor_interval = 4;
+}
+
+void FrameGovernor::AddPhaseTime(FRAME_PHASE phase, float seconds)
+{
+	// the first frame starts the averages off, rather than them climbing up from zero
+	if (!has_times_)
+		phase_times_[phase] = seconds;
+	else
+		phase_times_[phase] += (seconds - phase_times_[phase]) * kAverageWeight;
+}
+
+float FrameGovernor::load() const
+{
+	float slowest = 0.0f;
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		if (phase_times_[phase] > slowest)
+			slowest = phase_times_[phase];
+	}
+	return budget_ > 0.0f ? slowest / budget_ : 0.0f;
+}
+
+bool FrameGovernor::Update()
+{
+	has_times_ = true;
+
+	if (settle_frames_ > 0)
+	{
+		settle_frames_--;
+		return false;
+	}
+
+	float current_load = load();
+	over_frames_ = current_load > kStepDownLoad ? over_frames_ + 1 : 0;
+	under_frames_ = current_load < kStepUpLoad ? under_frames_ + 1 : 0;
+
+	QUALITY_TIER new_tier = tier_;
+	if (over_frames_ >= kStepDownFrames && tier_ < QUALITY_LOWEST)
+		new_tier = (QUALITY_TIER)(tier_ + 1);
+	else if (under_frames_ >= kStepUpFrames && tier_ > QUALITY_HIGH)
+		new_tier = (QUALITY_TIER)(tier_ - 1);
+
+	if (new_tier == tier_)
+		return false;
+
+	gef::DebugOut("Quality %s -> %s, load %.0f%% (simulation %.2fms, render %.2fms)\n", TierName(tier_), TierName(new_tier),
+		current_load * 100.0f, phase_times_[PHASE_SIMULATION] * 1000.0f, phase_times_[PHASE_RENDER] * 1000.0f);
+
+	tier_ = new_tier;
+	over_frames_ = 0;
+	under_frames_ = 0;
+	settle_frames_ = kSettleFrames;
+	return true;
+}
+
+void FrameGovernor::Reset()
+{
+	for (int phase = 0; phase < PHASE_COUNT; ++phase)
+		phase_times_[phase] = 0.0f;
+	has_times_ = false;
+	over_frames_ = 0;
+	under_frames_ = 0;
+	settle_frames_ = 0;
+	tier_ = QUALITY_HIGH;
+}
+
+const char* FrameGovernor::TierName(QUALITY_TIER tier)
+{
+	switch (tier)
+	{
+	case QUALITY_HIGH:
+		return "high";
+	case QUALITY_MEDIUM:
+		return "medium";
+	case QUALITY_LOW:
+		return "low";
+	case QUALITY_LOWEST:
+		return "lowest";
+	default:
+		return "unknown";
+	}
+}
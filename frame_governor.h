@@ -0,0 +1,96 @@
+#ifndef _FRAME_GOVERNOR_H
+#define _FRAME_GOVERNOR_H
+
+#include <gef.h>
+
+// How much optional work is done, from everything to the least that still looks right.
+enum QUALITY_TIER
+{
+	QUALITY_HIGH,
+	QUALITY_MEDIUM,
+	QUALITY_LOW,
+	QUALITY_LOWEST,
+	QUALITY_TIER_COUNT
+};
+
+// The parts of a frame that are timed. They run on different threads at the same time, so the frame takes as long
+// as the slowest of them.
+enum FRAME_PHASE
+{
+	PHASE_SIMULATION,
+	PHASE_RENDER,
+	PHASE_COUNT
+};
+
+// The optional work allowed at a quality tier. None of it changes gameplay.
+struct QualitySettings
+{
+	/// Shared actor poses are sampled at this step. Longer steps share more poses, so fewer are sampled.
+	float anim_time_step;
+
+	/// The fraction of each particle system's capacity that can be alive at once.
+	float particle_fraction;
+
+	/// The most sound effects that can be playing at once, and whether optional sounds like footsteps play at all.
+	int max_voices;
+	bool optional_sounds;
+
+	/// Actors further than far_actor_distance from the player animate at far_actor_interval times the pose step.
+	float far_actor_distance;
+	UInt32 far_actor_interval;
+};
+
+// Watches how long recent frames took against a frame budget, and picks a quality tier to keep them within it.
+// The tier steps down quickly when frames run over and back up slowly once there is room again, with a gap between
+// the two thresholds and a settling time after every change, so it doesn't flicker between tiers.
+class FrameGovernor
+{
+public:
+	/// @brief Constructor.
+	/// @param[in] budget	The time each frame should take, in seconds.
+	FrameGovernor(float budget = 1.0f / 60.0f);
+
+	/// @brief Record how long a phase of the last frame took.
+	/// @param[in] phase	The phase.
+	/// @param[in] seconds	How long it took.
+	void AddPhaseTime(FRAME_PHASE phase, float seconds);
+
+	/// @brief Call once a frame, after the phase times have been recorded, to move between tiers.
+	/// @return true if the tier changed.
+	bool Update();
+
+	/// @brief Go back to the highest tier and forget the recent times, e.g. when a level starts.
+	void Reset();
+
+	QUALITY_TIER tier() const { return tier_; }
+	const QualitySettings& settings() const { return settings_[tier_]; }
+
+	/// @brief The recent time of the slowest phase as a fraction of the budget.
+	float load() const;
+
+	/// @brief The recent time of a phase, in seconds.
+	float phase_time(FRAME_PHASE phase) const { return phase_times_[phase]; }
+
+	float budget() const { return budget_; }
+	void set_budget(float budget) { budget_ = budget; }
+
+	/// @brief Get a printable name for a tier.
+	static const char* TierName(QUALITY_TIER tier);
+
+private:
+	float budget_;
+
+	// Moving average of each phase's time.
+	float phase_times_[PHASE_COUNT];
+	bool has_times_;
+
+	// How many frames in a row have been over or under the thresholds, and how many frames are left to settle.
+	UInt32 over_frames_;
+	UInt32 under_frames_;
+	UInt32 settle_frames_;
+
+	QUALITY_TIER tier_;
+	QualitySettings settings_[QUALITY_TIER_COUNT];
+};
+
+#endif // _FRAME_GOVERNOR_H
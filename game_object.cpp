@@ -1,4 +1,5 @@
 #include "game_object.h"
+#include "collision_filter.h"
 #include <system/debug_log.h>
 
 GameObject::GameObject()
@@ -38,6 +39,13 @@ void GameObject::SetBody(b2BodyDef body_def, b2World* world)
 	body_ = world->CreateBody(&body_def);
 }
 
+b2Fixture* GameObject::CreateFixture(b2FixtureDef fixture_def)
+{
+	// the type decides what the fixture can collide with, so it must be set before the fixture is created
+	fixture_def.filter = CollisionFilter(type_);
+	return body_->CreateFixture(&fixture_def);
+}
+
 
 
 
@@ -16,6 +16,7 @@ enum OBJECT_TYPE
 	CRATE,
 	COIN,
 	CHECKPOINT,
+	WALL,
 	NONE
 };
 
@@ -30,9 +31,15 @@ public:
 	// Create a box2d body for the object.
 	void SetBody(b2BodyDef body_def, b2World* world);
 
+	// Create a fixture on the object's body, filtered by the collision matrix for the object's type.
+	b2Fixture* CreateFixture(b2FixtureDef fixture_def);
+
 	// Getter for the body.
 	b2Body* GetBody() { return body_; };
 
+	// Setter for the body, used when the object's body is moved into another physics world.
+	inline void set_body(b2Body* body) { body_ = body; }
+
 	// Setter and getter for the object's type.
 	inline void set_type(OBJECT_TYPE type) { type_ = type; }
 	inline OBJECT_TYPE type() { return type_; }
@@ -0,0 +1,259 @@
+#include "input_service.h"
+#include <input/input_manager.h>
+#include <input/sony_controller_input_manager.h>
+#include <input/touch_input_manager.h>
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+	// stick movements smaller than this aren't worth an event
+	const float kStickThreshold = 0.01f;
+}
+
+InputState::InputState()
+{
+	Clear();
+}
+
+void InputState::BeginStep()
+{
+	memset(keys_pressed_, 0, sizeof(keys_pressed_));
+	buttons_pressed_ = 0;
+	touch_events_.clear();
+}
+
+void InputState::Clear()
+{
+	BeginStep();
+	memset(keys_down_, 0, sizeof(keys_down_));
+	buttons_down_ = 0;
+	left_stick_x_ = 0.0f;
+	left_stick_y_ = 0.0f;
+}
+
+void InputState::Apply(const InputEvent& event)
+{
+	switch (event.type)
+	{
+	case INPUT_KEY_DOWN:
+		keys_down_[event.code] = 1;
+		keys_pressed_[event.code] = 1;
+		break;
+	case INPUT_KEY_UP:
+		keys_down_[event.code] = 0;
+		break;
+	case INPUT_BUTTON_DOWN:
+		buttons_down_ |= (UInt32)event.code;
+		buttons_pressed_ |= (UInt32)event.code;
+		break;
+	case INPUT_BUTTON_UP:
+		buttons_down_ &= ~(UInt32)event.code;
+		break;
+	case INPUT_STICK:
+		left_stick_x_ = event.x;
+		left_stick_y_ = event.y;
+		break;
+	case INPUT_TOUCH_NEW:
+	case INPUT_TOUCH_RELEASED:
+		touch_events_.push_back(event);
+		break;
+	case INPUT_RESET:
+		Clear();
+		break;
+	case INPUT_KEY_HELD:
+		keys_down_[event.code] = 1;
+		break;
+	case INPUT_BUTTON_HELD:
+		buttons_down_ |= (UInt32)event.code;
+		break;
+	}
+}
+
+InputService::InputService() :
+	input_manager_(NULL),
+	poll_interval_(0),
+	quit_(false),
+	polling_(false),
+	needs_baseline_(true),
+	buttons_down_(0),
+	left_stick_x_(0.0f),
+	left_stick_y_(0.0f),
+	dropped_count_(0)
+{
+	memset(keys_down_, 0, sizeof(keys_down_));
+}
+
+InputService::~InputService()
+{
+	Stop();
+}
+
+void InputService::Start(gef::InputManager* input_manager, float poll_rate)
+{
+	Stop();
+
+	input_manager_ = input_manager;
+	poll_interval_ = (UInt64)(1000000.0f / poll_rate);
+	quit_ = false;
+	polling_ = false;
+	needs_baseline_ = true;
+	thread_ = std::thread(&InputService::Run, this);
+}
+
+void InputService::Stop()
+{
+	if (thread_.joinable())
+	{
+		quit_ = true;
+		thread_.join();
+	}
+}
+
+void InputService::SetPolling(bool polling)
+{
+	std::lock_guard<std::mutex> lock(poll_mutex_);
+	if (polling == polling_)
+		return;
+
+	polling_ = polling;
+	if (polling_)
+	{
+		needs_baseline_ = true;
+	}
+	else
+	{
+		// nothing is consuming, so it's safe to empty the queue from this thread
+		while (events_.Front())
+			events_.Pop();
+	}
+}
+
+UInt32 InputService::Consume(InputState& state, UInt64 time)
+{
+	UInt32 count = 0;
+	for (const InputEvent* event = events_.Front(); event && event->time <= time; event = events_.Front())
+	{
+		state.Apply(*event);
+		events_.Pop();
+		count++;
+	}
+	return count;
+}
+
+UInt64 InputService::Now()
+{
+	return (UInt64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void InputService::Run()
+{
+	UInt64 next_poll = Now();
+	while (!quit_)
+	{
+		{
+			std::lock_guard<std::mutex> lock(poll_mutex_);
+			if (polling_)
+			{
+				Poll(needs_baseline_);
+				needs_baseline_ = false;
+			}
+		}
+
+		// sleep until the next poll is due. If polling fell behind, start again from now rather than polling in a burst
+		next_poll += poll_interval_;
+		UInt64 now = Now();
+		if (next_poll < now)
+			next_poll = now;
+		else
+			std::this_thread::sleep_for(std::chrono::microseconds(next_poll - now));
+	}
+}
+
+void InputService::Poll(bool baseline)
+{
+	input_manager_->Update();
+	const UInt64 time = Now();
+
+	// events dropped while paused may have left the consumer out of step, so start it again from nothing
+	if (baseline)
+		Queue(INPUT_RESET, 0, 0.0f, 0.0f, time);
+
+	// keyboard
+	const gef::Keyboard* keyboard = input_manager_->keyboard();
+	if (keyboard)
+	{
+		for (Int32 key = 0; key < gef::Keyboard::NUM_KEY_CODES; ++key)
+		{
+			UInt8 down = keyboard->IsKeyDown((gef::Keyboard::KeyCode)key) ? 1 : 0;
+			if (baseline)
+			{
+				if (down)
+					Queue(INPUT_KEY_HELD, key, 0.0f, 0.0f, time);
+			}
+			else if (down != keys_down_[key])
+			{
+				Queue(down ? INPUT_KEY_DOWN : INPUT_KEY_UP, key, 0.0f, 0.0f, time);
+			}
+			keys_down_[key] = down;
+		}
+	}
+
+	// first controller's buttons and left stick
+	const gef::SonyControllerInputManager* controller_manager = input_manager_->controller_input();
+	const gef::SonyController* controller = controller_manager ? controller_manager->GetController(0) : NULL;
+	if (controller)
+	{
+		UInt32 buttons_down = controller->buttons_down();
+		UInt32 changed = baseline ? buttons_down : buttons_down ^ buttons_down_;
+		for (UInt32 button = 1; changed != 0; button <<= 1)
+		{
+			if (changed & button)
+			{
+				changed &= ~button;
+				if (baseline)
+					Queue(INPUT_BUTTON_HELD, (Int32)button, 0.0f, 0.0f, time);
+				else
+					Queue(buttons_down & button ? INPUT_BUTTON_DOWN : INPUT_BUTTON_UP, (Int32)button, 0.0f, 0.0f, time);
+			}
+		}
+		buttons_down_ = buttons_down;
+
+		float stick_x = controller->left_stick_x_axis();
+		float stick_y = controller->left_stick_y_axis();
+		if (baseline || fabsf(stick_x - left_stick_x_) > kStickThreshold || fabsf(stick_y - left_stick_y_) > kStickThreshold)
+		{
+			left_stick_x_ = stick_x;
+			left_stick_y_ = stick_y;
+			Queue(INPUT_STICK, 0, stick_x, stick_y, time);
+		}
+	}
+
+	// touches on the first panel. The input manager only reports a touch as new or released on the update it happens,
+	// so there is nothing to compare against
+	const gef::TouchInputManager* touch_input = input_manager_->touch_manager();
+	if (touch_input && touch_input->max_num_panels() > 0 && !baseline)
+	{
+		const gef::TouchContainer& panel_touches = touch_input->touches(0);
+		for (gef::ConstTouchIterator touch = panel_touches.begin(); touch != panel_touches.end(); ++touch)
+		{
+			if (touch->type == gef::TT_NEW)
+				Queue(INPUT_TOUCH_NEW, touch->id, touch->position.x, touch->position.y, time);
+			else if (touch->type == gef::TT_RELEASED)
+				Queue(INPUT_TOUCH_RELEASED, touch->id, touch->position.x, touch->position.y, time);
+		}
+	}
+}
+
+void InputService::Queue(INPUT_EVENT_TYPE type, Int32 code, float x, float y, UInt64 time)
+{
+	InputEvent event;
+	event.time = time;
+	event.type = type;
+	event.code = code;
+	event.x = x;
+	event.y = y;
+
+	if (!events_.Push(event))
+		dropped_count_++;
+}
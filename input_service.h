@@ -0,0 +1,153 @@
+#ifndef _INPUT_SERVICE_H
+#define _INPUT_SERVICE_H
+
+#include <gef.h>
+#include <input/keyboard.h>
+#include "spsc_queue.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+namespace gef
+{
+	class InputManager;
+}
+
+// The kinds of input event.
+enum INPUT_EVENT_TYPE
+{
+	INPUT_KEY_DOWN,
+	INPUT_KEY_UP,
+	INPUT_BUTTON_DOWN,
+	INPUT_BUTTON_UP,
+	INPUT_STICK,
+	INPUT_TOUCH_NEW,
+	INPUT_TOUCH_RELEASED,
+
+	// Sent when polling resumes: forget everything held, then a held event for each key and button that is down.
+	// Held keys and buttons don't count as pressed.
+	INPUT_RESET,
+	INPUT_KEY_HELD,
+	INPUT_BUTTON_HELD
+};
+
+// A change in input, stamped with the time it was seen.
+struct InputEvent
+{
+	/// Microseconds, from InputService::Now.
+	UInt64 time;
+	INPUT_EVENT_TYPE type;
+
+	/// The key code for key events, the button bit for button events, the touch id for touch events.
+	Int32 code;
+
+	/// The left stick position for stick events, the touch position for touch events.
+	float x;
+	float y;
+};
+
+// The input seen by one simulation step, built up from events.
+// Keys and buttons that went down during the step count as pressed even if they were released again before the
+// step, so short presses aren't lost.
+class InputState
+{
+public:
+	InputState();
+
+	/// @brief Start a new step. Forgets which keys and buttons were pressed and the touch events, keeps what is held down.
+	void BeginStep();
+
+	/// @brief Forget everything, as if nothing is held down.
+	void Clear();
+
+	/// @brief Apply an event to the state.
+	void Apply(const InputEvent& event);
+
+	bool IsKeyDown(gef::Keyboard::KeyCode key) const { return keys_down_[key] != 0; }
+	bool IsKeyPressed(gef::Keyboard::KeyCode key) const { return keys_pressed_[key] != 0; }
+
+	UInt32 buttons_down() const { return buttons_down_; }
+	UInt32 buttons_pressed() const { return buttons_pressed_; }
+
+	float left_stick_x() const { return left_stick_x_; }
+	float left_stick_y() const { return left_stick_y_; }
+
+	/// @brief The touch events applied since BeginStep, in the order they happened.
+	const std::vector<InputEvent>& touch_events() const { return touch_events_; }
+
+private:
+	UInt8 keys_down_[gef::Keyboard::NUM_KEY_CODES];
+	UInt8 keys_pressed_[gef::Keyboard::NUM_KEY_CODES];
+	UInt32 buttons_down_;
+	UInt32 buttons_pressed_;
+	float left_stick_x_;
+	float left_stick_y_;
+	std::vector<InputEvent> touch_events_;
+};
+
+// Polls the keyboard, first controller and touch panel at a fixed rate on its own thread, and queues a timestamped
+// event for every change. The simulation consumes the events each step, so presses shorter than a frame are still seen
+// and the delay between a press and the simulation seeing it doesn't depend on how long frames take to render.
+class InputService
+{
+public:
+	InputService();
+	~InputService();
+
+	/// @brief Start the polling thread. It starts paused, call SetPolling to begin.
+	/// @param[in] input_manager	The input manager to poll. It isn't thread-safe: the service calls its Update, so nothing else may
+	/// update or read it while the service is polling.
+	/// @param[in] poll_rate		Polls per second.
+	void Start(gef::InputManager* input_manager, float poll_rate = 500.0f);
+
+	/// @brief Stop polling and end the thread.
+	void Stop();
+
+	/// @brief Pause or resume polling, e.g. so the menus can use the input manager directly.
+	/// Returns once any poll in progress has finished. Pausing drops any queued events, so must only be called when
+	/// nothing is consuming. The first poll after resuming sends a reset and what is held down, rather than presses.
+	void SetPolling(bool polling);
+
+	/// @brief Apply the queued events up to a time to a state, in order. Only call from one thread at a time.
+	/// @param[out] state	The state to apply the events to.
+	/// @param[in] time		Events after this time are left queued.
+	/// @return The number of events applied.
+	UInt32 Consume(InputState& state, UInt64 time);
+
+	/// @brief The number of events dropped because the queue was full.
+	UInt32 dropped_count() const { return dropped_count_; }
+
+	/// @brief The current time in microseconds, on the same clock as the event times.
+	static UInt64 Now();
+
+private:
+	void Run();
+
+	// Poll the input manager and queue an event for each change since the last poll.
+	// If baseline is true, queue a reset and the whole held state instead.
+	void Poll(bool baseline);
+	void Queue(INPUT_EVENT_TYPE type, Int32 code, float x, float y, UInt64 time);
+
+	gef::InputManager* input_manager_;
+	UInt64 poll_interval_;
+
+	std::thread thread_;
+	std::atomic<bool> quit_;
+
+	// Held while polling, so SetPolling can wait for a poll to finish.
+	std::mutex poll_mutex_;
+	bool polling_;
+	bool needs_baseline_;
+
+	// The state at the last poll, to compare against.
+	UInt8 keys_down_[gef::Keyboard::NUM_KEY_CODES];
+	UInt32 buttons_down_;
+	float left_stick_x_;
+	float left_stick_y_;
+
+	SpscQueue<InputEvent, 1024> events_;
+	std::atomic<UInt32> dropped_count_;
+};
+
+#endif // _INPUT_SERVICE_H
@@ -0,0 +1,128 @@
+#include "level_arena.h"
+#include <cstdint>
+
+namespace
+{
+	// Blocks are allocated with new char[], so the data after the header is only as aligned as the heap makes it.
+	const size_t kHeaderAlignment = 16;
+
+	// The offset into a block's data where the next allocation can start, so that its address is aligned.
+	// The address itself is aligned rather than the offset, as the block may not be.
+	size_t AlignedOffset(const char* data, size_t used, size_t alignment)
+	{
+		uintptr_t address = reinterpret_cast<uintptr_t>(data) + used;
+		uintptr_t aligned = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		return used + (size_t)(aligned - address);
+	}
+}
+
+LevelArena::LevelArena(size_t block_size) :
+	current_block_(NULL),
+	blocks_(NULL),
+	finalisers_(NULL),
+	block_size_(block_size)
+{
+	for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+		tag_bytes_[tag] = 0;
+}
+
+LevelArena::~LevelArena()
+{
+	Release();
+
+	while (blocks_)
+	{
+		Block* next = blocks_->next;
+		delete[] reinterpret_cast<char*>(blocks_);
+		blocks_ = next;
+	}
+	current_block_ = NULL;
+}
+
+void* LevelArena::Allocate(size_t size, MEMORY_TAG tag, size_t alignment)
+{
+	const size_t header_size = (sizeof(Block) + kHeaderAlignment - 1) & ~(kHeaderAlignment - 1);
+
+	// find a block with enough space, starting from the current one so earlier full blocks aren't searched again
+	Block* block = current_block_ ? current_block_ : blocks_;
+	while (block)
+	{
+		size_t offset = AlignedOffset(reinterpret_cast<char*>(block) + header_size, block->used, alignment);
+		if (offset + size <= block->size)
+			break;
+		block = block->next;
+	}
+
+	// allocate a new block if none of the existing ones have room, large requests get a block to themselves
+	// the extra alignment bytes leave room to align the first allocation, however the heap aligned the block
+	if (!block)
+	{
+		size_t data_size = size + alignment > block_size_ ? size + alignment : block_size_;
+		block = reinterpret_cast<Block*>(new char[header_size + data_size]);
+		block->size = data_size;
+		block->used = 0;
+		block->next = NULL;
+
+		// append so the blocks are reused in the same order after a release
+		Block** tail = &blocks_;
+		while (*tail)
+			tail = &(*tail)->next;
+		*tail = block;
+	}
+
+	current_block_ = block;
+
+	char* data = reinterpret_cast<char*>(block) + header_size;
+	size_t offset = AlignedOffset(data, block->used, alignment);
+	block->used = offset + size;
+
+	Track(tag, size);
+
+	return data + offset;
+}
+
+void LevelArena::Track(MEMORY_TAG tag, size_t bytes)
+{
+	tag_bytes_[tag] += bytes;
+	MemoryTracker::Allocated(tag, bytes);
+}
+
+void LevelArena::AddFinaliser(void(*function)(void*), void* object)
+{
+	Finaliser* finaliser = new (Allocate(sizeof(Finaliser), MEMORY_OTHER, alignof(Finaliser))) Finaliser();
+	finaliser->function = function;
+	finaliser->object = object;
+	finaliser->next = finalisers_;
+	finalisers_ = finaliser;
+}
+
+void LevelArena::Release()
+{
+	// destroy objects newest first, so anything created from an earlier object goes before it
+	while (finalisers_)
+	{
+		Finaliser* finaliser = finalisers_;
+		finalisers_ = finaliser->next;
+		finaliser->function(finaliser->object);
+	}
+
+	// everything in the arena is freed at once
+	for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+	{
+		MemoryTracker::Freed((MEMORY_TAG)tag, tag_bytes_[tag]);
+		tag_bytes_[tag] = 0;
+	}
+
+	// keep the blocks so the next level can reuse them
+	for (Block* block = blocks_; block; block = block->next)
+		block->used = 0;
+	current_block_ = blocks_;
+}
+
+size_t LevelArena::capacity() const
+{
+	size_t total = 0;
+	for (Block* block = blocks_; block; block = block->next)
+		total += block->size;
+	return total;
+}
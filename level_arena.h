@@ -0,0 +1,105 @@
+#ifndef _LEVEL_ARENA_H
+#define _LEVEL_ARENA_H
+
+#include "memory_tracker.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Allocator for everything that lives as long as a level.
+// Memory is handed out linearly from large blocks and everything is released in one go when the level unloads.
+// The blocks are kept for the next level, so repeatedly loading levels doesn't grow the heap.
+class LevelArena
+{
+public:
+	/// @brief Constructor.
+	/// @param[in] block_size	The size of each block the arena allocates from.
+	LevelArena(size_t block_size = 64 * 1024);
+
+	/// @brief Releases everything and frees the blocks.
+	~LevelArena();
+
+	/// @brief Allocate raw memory. It is not freed until Release is called.
+	/// @return Pointer to the memory.
+	/// @param[in] size			The number of bytes to allocate.
+	/// @param[in] tag			The subsystem the memory is tracked against.
+	/// @param[in] alignment	The alignment of the memory. Must be a power of two.
+	void* Allocate(size_t size, MEMORY_TAG tag, size_t alignment = 16);
+
+	/// @brief Construct an object in the arena. Its destructor is called when the arena is released.
+	/// @return The new object.
+	/// @param[in] tag			The subsystem the object is tracked against.
+	/// @param[in] args			The arguments passed to the object's constructor.
+	template <typename T, typename... Args>
+	T* New(MEMORY_TAG tag, Args&&... args)
+	{
+		T* object = new (Allocate(sizeof(T), tag, alignof(T))) T(std::forward<Args>(args)...);
+		AddFinaliser(&Destruct<T>, object);
+		return object;
+	}
+
+	/// @brief Take ownership of an object created elsewhere, e.g. by a gef factory. It is deleted when the arena is released.
+	/// @return The object, to allow calls to be chained.
+	/// @param[in] object		The object to own. NULL is ignored.
+	/// @param[in] tag			The subsystem the object is tracked against.
+	/// @param[in] bytes		The amount of memory the object holds on to.
+	template <typename T>
+	T* Adopt(T* object, MEMORY_TAG tag, size_t bytes)
+	{
+		if (object)
+		{
+			Track(tag, bytes);
+			AddFinaliser(&Delete<T>, object);
+		}
+		return object;
+	}
+
+	/// @brief Record memory held by something the arena already owns, so it is counted until the arena is released.
+	void Track(MEMORY_TAG tag, size_t bytes);
+
+	/// @brief Destroy every object in the arena and make all of its memory available again.
+	void Release();
+
+	/// @brief The bytes currently allocated against a tag.
+	size_t bytes(MEMORY_TAG tag) const { return tag_bytes_[tag]; }
+
+	/// @brief The total size of the blocks held by the arena.
+	size_t capacity() const;
+
+private:
+	// A block of memory, the data follows the header.
+	struct Block
+	{
+		Block* next;
+		size_t size;
+		size_t used;
+	};
+
+	// Something to call when the arena is released. Allocated in the arena itself.
+	struct Finaliser
+	{
+		void(*function)(void*);
+		void* object;
+		Finaliser* next;
+	};
+
+	void AddFinaliser(void(*function)(void*), void* object);
+
+	template <typename T>
+	static void Destruct(void* object) { static_cast<T*>(object)->~T(); }
+
+	template <typename T>
+	static void Delete(void* object) { delete static_cast<T*>(object); }
+
+	// The block currently being allocated from, and the list of all blocks.
+	Block* current_block_;
+	Block* blocks_;
+
+	// Finalisers are run in the reverse order to which they were added.
+	Finaliser* finalisers_;
+
+	size_t block_size_;
+	size_t tag_bytes_[MEMORY_TAG_COUNT];
+};
+
+#endif // _LEVEL_ARENA_H
@@ -1,11 +1,12 @@
 #include "load_texture.h"
+#include "asset_blob.h"
 
 #include <assets/png_loader.h>
 #include <graphics/image_data.h>
 #include <graphics/texture.h>
 #include <cstdlib>
 
-gef::Texture* CreateTextureFromPNG(const char* png_filename, gef::Platform& platform)
+gef::Texture* CreateTextureFromPNG(const char* png_filename, gef::Platform& platform, UInt32* byte_size)
 {
 	gef::PNGLoader png_loader;
 	gef::ImageData image_data;
@@ -16,7 +17,53 @@ gef::Texture* CreateTextureFromPNG(const char* png_filename, gef::Platform& plat
 
 	// if the image data is valid, then create a texture from it
 	if (image_data.image() != NULL)
+	{
 		texture = gef::Texture::Create(platform, image_data);
+		if (byte_size)
+			*byte_size = image_data.width() * image_data.height() * 4;
+	}
+
+	return texture;
+}
+
+gef::Texture* CreateTextureFromBlob(const char* blob_filename, gef::Platform& platform, UInt32* byte_size)
+{
+	AssetBlob blob;
+	gef::Texture* texture = NULL;
+
+	if (blob.Load(blob_filename) && blob.type() == BLOB_TEXTURE)
+	{
+		const TextureInfo* info = static_cast<const TextureInfo*>(blob.FindSection(SECTION_TEXTURE_INFO));
+		const void* texels = blob.FindSection(SECTION_TEXELS);
+
+		if (info && texels)
+		{
+			// point the image data straight at the texels in the blob, no decoding needed
+			gef::ImageData image_data;
+			image_data.set_width(info->width);
+			image_data.set_height(info->height);
+			image_data.set_image(static_cast<UInt8*>(const_cast<void*>(texels)));
+
+			texture = gef::Texture::Create(platform, image_data);
+			if (byte_size)
+				*byte_size = info->width * info->height * 4;
+
+			// the blob owns the texels, so stop the image data from freeing them
+			image_data.set_image(NULL);
+		}
+	}
+
+	return texture;
+}
+
+gef::Texture* LoadTexture(const char* png_filename, gef::Platform& platform, UInt32* byte_size)
+{
+	char blob_filename[256];
+	AssetBlob::CookedFilename(png_filename, BLOB_TEXTURE, blob_filename, sizeof(blob_filename));
+
+	gef::Texture* texture = CreateTextureFromBlob(blob_filename, platform, byte_size);
+	if (!texture)
+		texture = CreateTextureFromPNG(png_filename, platform, byte_size);
 
 	return texture;
 }
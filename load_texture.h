@@ -5,7 +5,12 @@
 #include <graphics/texture.h>
 
 // FUNCTION PROTOTYPES
-gef::Texture* CreateTextureFromPNG(const char* png_filename, gef::Platform& platform);
+// byte_size is optional, and is set to the size of the texel data the texture was created from.
+gef::Texture* CreateTextureFromPNG(const char* png_filename, gef::Platform& platform, UInt32* byte_size = NULL);
+gef::Texture* CreateTextureFromBlob(const char* blob_filename, gef::Platform& platform, UInt32* byte_size = NULL);
+
+// Loads the cooked version of a texture if there is one, otherwise decodes the PNG.
+gef::Texture* LoadTexture(const char* png_filename, gef::Platform& platform, UInt32* byte_size = NULL);
 
 #endif // _LOAD_TEXTURE_H
 
@@ -0,0 +1,63 @@
+#include "memory_tracker.h"
+#include <system/debug_log.h>
+
+size_t MemoryTracker::current_bytes_[MEMORY_TAG_COUNT] = { 0 };
+size_t MemoryTracker::peak_bytes_[MEMORY_TAG_COUNT] = { 0 };
+size_t MemoryTracker::total_current_bytes_ = 0;
+size_t MemoryTracker::total_peak_bytes_ = 0;
+std::mutex MemoryTracker::mutex_;
+
+void MemoryTracker::Allocated(MEMORY_TAG tag, size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	current_bytes_[tag] += bytes;
+	if (current_bytes_[tag] > peak_bytes_[tag])
+		peak_bytes_[tag] = current_bytes_[tag];
+
+	total_current_bytes_ += bytes;
+	if (total_current_bytes_ > total_peak_bytes_)
+		total_peak_bytes_ = total_current_bytes_;
+}
+
+void MemoryTracker::Freed(MEMORY_TAG tag, size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// clamp rather than wrap if something is freed that was never recorded
+	current_bytes_[tag] -= bytes < current_bytes_[tag] ? bytes : current_bytes_[tag];
+	total_current_bytes_ -= bytes < total_current_bytes_ ? bytes : total_current_bytes_;
+}
+
+const char* MemoryTracker::TagName(MEMORY_TAG tag)
+{
+	switch (tag)
+	{
+	case MEMORY_PHYSICS:
+		return "physics";
+	case MEMORY_ANIMATION:
+		return "animation";
+	case MEMORY_MESHES:
+		return "meshes";
+	case MEMORY_TEXTURES:
+		return "textures";
+	case MEMORY_AUDIO:
+		return "audio";
+	case MEMORY_OTHER:
+		return "other";
+	default:
+		return "unknown";
+	}
+}
+
+void MemoryTracker::Report()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	gef::DebugOut("Memory         current (KB)    peak (KB)\n");
+	for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+	{
+		gef::DebugOut("%-12s %12.1f %12.1f\n", TagName((MEMORY_TAG)tag), current_bytes_[tag] / 1024.0f, peak_bytes_[tag] / 1024.0f);
+	}
+	gef::DebugOut("%-12s %12.1f %12.1f\n", "total", total_current_bytes_ / 1024.0f, total_peak_bytes_ / 1024.0f);
+}
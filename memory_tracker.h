@@ -0,0 +1,53 @@
+#ifndef _MEMORY_TRACKER_H
+#define _MEMORY_TRACKER_H
+
+#include <cstddef>
+#include <mutex>
+
+// The subsystems that memory is tracked against.
+enum MEMORY_TAG
+{
+	MEMORY_PHYSICS,
+	MEMORY_ANIMATION,
+	MEMORY_MESHES,
+	MEMORY_TEXTURES,
+	MEMORY_AUDIO,
+	MEMORY_OTHER,
+	MEMORY_TAG_COUNT
+};
+
+// Keeps a running total of the current and peak bytes allocated by each subsystem.
+// Levels are built on a background thread, so the totals are guarded by a mutex.
+class MemoryTracker
+{
+public:
+	/// @brief Record an allocation.
+	/// @param[in] tag		The subsystem the memory belongs to.
+	/// @param[in] bytes	The size of the allocation.
+	static void Allocated(MEMORY_TAG tag, size_t bytes);
+
+	/// @brief Record memory being freed.
+	/// @param[in] tag		The subsystem the memory belonged to.
+	/// @param[in] bytes	The size of the allocation.
+	static void Freed(MEMORY_TAG tag, size_t bytes);
+
+	static size_t current_bytes(MEMORY_TAG tag) { return current_bytes_[tag]; }
+	static size_t peak_bytes(MEMORY_TAG tag) { return peak_bytes_[tag]; }
+	static size_t total_current_bytes() { return total_current_bytes_; }
+	static size_t total_peak_bytes() { return total_peak_bytes_; }
+
+	/// @brief Get a printable name for a tag.
+	static const char* TagName(MEMORY_TAG tag);
+
+	/// @brief Write the current and peak bytes for each subsystem to the debug output.
+	static void Report();
+
+private:
+	static size_t current_bytes_[MEMORY_TAG_COUNT];
+	static size_t peak_bytes_[MEMORY_TAG_COUNT];
+	static size_t total_current_bytes_;
+	static size_t total_peak_bytes_;
+	static std::mutex mutex_;
+};
+
+#endif // _MEMORY_TRACKER_H
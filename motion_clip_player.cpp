@@ -16,6 +16,31 @@ void MotionClipPlayer::Init(const gef::SkeletonPose& bind_pose)
 }
 
 bool MotionClipPlayer::Update(const float delta_time, const gef::SkeletonPose& bind_pose)
+{
+	bool finished = Advance(delta_time);
+
+	if (clip_)
+	{
+		// add the clip start time to the playback time to calculate the final time
+		// that will be used to sample the animation data
+		float time = anim_time_+clip_->start_time();
+
+		// sample the animation data at the calculated time
+		// any bones that don't have animation data are set to the bind pose
+		clip_->Sample(pose_, bind_pose, time);
+	}
+	else
+	{
+		// no animation associated with this player
+		// just set the pose to the bind pose
+		pose_ = bind_pose;
+	}
+
+	// return true if we have reached the end of the animation, always false when playback is looped
+	return finished;
+}
+
+bool MotionClipPlayer::Advance(const float delta_time)
 {
 	bool finished = false;
 
@@ -37,23 +62,8 @@ bool MotionClipPlayer::Update(const float delta_time, const gef::SkeletonPose& b
 				finished = true;
 			}
 		}
-
-		// add the clip start time to the playback time to calculate the final time
-		// that will be used to sample the animation data
-		float time = anim_time_+clip_->start_time();
-
-		// sample the animation data at the calculated time
-		// any bones that don't have animation data are set to the bind pose
-		pose_.SetPoseFromAnim(*clip_, bind_pose, time);
-	}
-	else
-	{
-		// no animation associated with this player
-		// just set the pose to the bind pose
-		pose_ = bind_pose;
 	}
 
-	// return true if we have reached the end of the animation, always false when playback is looped
 	return finished;
 }
 
@@ -86,8 +96,20 @@ gef::Skeleton* MotionClipPlayer::GetFirstSkeleton(gef::Scene* scene)
 	return skeleton;
 }
 
-gef::Animation* MotionClipPlayer::LoadAnimation(const char* anim_scene_filename, const char* anim_name, gef::Platform* platform)
+AnimClip* MotionClipPlayer::LoadAnimation(const char* anim_scene_filename, const char* anim_name, gef::Platform* platform)
 {
+	// cooked clips only hold the first animation in the file, so only use them when a specific animation isn't asked for
+	if (!anim_name || anim_name[0] == '\0')
+	{
+		char blob_filename[256];
+		AssetBlob::CookedFilename(anim_scene_filename, BLOB_CLIP, blob_filename, sizeof(blob_filename));
+
+		AnimClip* cooked_clip = new AnimClip();
+		if (cooked_clip->LoadCooked(blob_filename))
+			return cooked_clip;
+		delete cooked_clip;
+	}
+
 	gef::Animation* anim = NULL;
 
 	gef::Scene anim_scene;
@@ -105,5 +127,5 @@ gef::Animation* MotionClipPlayer::LoadAnimation(const char* anim_scene_filename,
 			anim = new gef::Animation(*anim_node_iter->second);
 	}
 
-	return anim;
+	return anim ? new AnimClip(anim) : NULL;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <animation/skeleton.h>
 #include <graphics/scene.h>
+#include "anim_clip.h"
 
 namespace gef
 {
@@ -23,6 +24,12 @@ public:
 	/// @param[in] bind_pose	The bind pose for the skeleton being animated.
 	bool Update(const float delta_time, const gef::SkeletonPose& bind_pose);
 
+	/// @brief Update the playback time without sampling a pose. Update uses it before sampling.
+	/// Actors sharing poses through a PoseCache set their time from its shared clock with set_anim_time instead.
+	/// @param[in] delta_time	The amount of time to update the playback time by.
+	/// @return true if a non-looping clip has reached its end.
+	bool Advance(const float delta_time);
+
 	const float anim_time() const { return anim_time_; }
 	void set_anim_time(const float anim_time) { anim_time_ = anim_time; }
 
@@ -32,21 +39,26 @@ public:
 	const bool looping() const { return looping_; }
 	void set_looping(const bool looping) { looping_ = looping; }
 
-	const gef::Animation* clip() const { return clip_; }
-	void set_clip(const gef::Animation* clip) { clip_ = clip; }
+	const AnimClip* clip() const { return clip_; }
+	void set_clip(const AnimClip* clip) { clip_ = clip; }
 
 	const gef::SkeletonPose& pose() const { return pose_; }
 
 	static gef::Mesh* GetFirstMesh(gef::Scene* scene, gef::Platform* platform);
 	static gef::Skeleton* GetFirstSkeleton(gef::Scene* scene);
-	static gef::Animation* LoadAnimation(const char* anim_scene_filename, const char* anim_name, gef::Platform* platform);
+
+	/// @brief Load an animation clip, using the cooked version if there is one.
+	/// @param[in] anim_scene_filename	The scene file containing the animation.
+	/// @param[in] anim_name			The animation to load. The first animation is used if empty or NULL.
+	/// @param[in] platform				The platform the animation is being loaded on.
+	static AnimClip* LoadAnimation(const char* anim_scene_filename, const char* anim_name, gef::Platform* platform);
 
 private:
 	/// The pose created by sampling the animation clip
 	gef::SkeletonPose pose_;
 
 	/// A pointer to the animation clip to be sampled
-	const gef::Animation* clip_;
+	const AnimClip* clip_;
 
 	/// The current playback time the animation clip is being sampled at
 	float anim_time_;
@@ -0,0 +1,203 @@
+#include "particle_system.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#define PARTICLES_USE_SSE
+#endif
+
+namespace
+{
+	const UInt32 kArrayCount = 10;
+}
+
+ParticleBurst::ParticleBurst() :
+	position(0.0f, 0.0f, 0.0f),
+	position_spread(0.0f, 0.0f, 0.0f),
+	velocity_min_x(0.0f), velocity_max_x(0.0f),
+	velocity_min_y(0.0f), velocity_max_y(0.0f),
+	spin_min(0.0f), spin_max(0.0f),
+	scale_min(1.0f), scale_max(1.0f),
+	lifetime_min(1.0f), lifetime_max(1.0f),
+	floor_y(0.0f),
+	count(0)
+{
+}
+
+ParticleSystem::ParticleSystem(UInt32 capacity) :
+	count_(0),
+	capacity_(capacity),
+	limit_(capacity),
+	gravity_(-9.81f),
+	restitution_(0.3f),
+	friction_(0.7f),
+	random_seed_(12345)
+{
+	// round up so every array is a whole number of SIMD lanes
+	UInt32 stride = (capacity_ + 3) & ~3u;
+
+	data_ = new float[stride * kArrayCount];
+	memset(data_, 0, sizeof(float) * stride * kArrayCount);
+
+	position_x_ = data_;
+	position_y_ = position_x_ + stride;
+	position_z_ = position_y_ + stride;
+	velocity_x_ = position_z_ + stride;
+	velocity_y_ = velocity_x_ + stride;
+	angle_ = velocity_y_ + stride;
+	spin_ = angle_ + stride;
+	scale_ = spin_ + stride;
+	life_ = scale_ + stride;
+	floor_y_ = life_ + stride;
+}
+
+ParticleSystem::~ParticleSystem()
+{
+	delete[] data_;
+	data_ = NULL;
+}
+
+float ParticleSystem::Random(float min, float max)
+{
+	// a simple lcg is plenty for cosmetic spread, and doesn't share state with rand()
+	random_seed_ = random_seed_ * 1664525u + 1013904223u;
+	float t = (random_seed_ >> 8) * (1.0f / 16777216.0f);
+	return min + (max - min) * t;
+}
+
+void ParticleSystem::Emit(const ParticleBurst& burst)
+{
+	for (UInt32 burst_num = 0; burst_num < burst.count && count_ < limit_; ++burst_num)
+	{
+		UInt32 i = count_++;
+		position_x_[i] = burst.position.x() + Random(-burst.position_spread.x(), burst.position_spread.x());
+		position_y_[i] = burst.position.y() + Random(-burst.position_spread.y(), burst.position_spread.y());
+		position_z_[i] = burst.position.z() + Random(-burst.position_spread.z(), burst.position_spread.z());
+		velocity_x_[i] = Random(burst.velocity_min_x, burst.velocity_max_x);
+		velocity_y_[i] = Random(burst.velocity_min_y, burst.velocity_max_y);
+		angle_[i] = 0.0f;
+		spin_[i] = Random(burst.spin_min, burst.spin_max);
+		scale_[i] = Random(burst.scale_min, burst.scale_max);
+		life_[i] = Random(burst.lifetime_min, burst.lifetime_max);
+		floor_y_[i] = burst.floor_y;
+	}
+}
+
+void ParticleSystem::Update(float time_step)
+{
+	if (count_ == 0)
+		return;
+
+	UInt32 i = 0;
+
+#ifdef PARTICLES_USE_SSE
+	const __m128 dt = _mm_set1_ps(time_step);
+	const __m128 gravity_dt = _mm_set1_ps(gravity_ * time_step);
+	const __m128 bounce = _mm_set1_ps(-restitution_);
+	const __m128 friction = _mm_set1_ps(friction_);
+
+	// four particles at a time, the arrays are padded so the last group can run past count_
+	for (; i < count_; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(position_x_ + i);
+		__m128 y = _mm_loadu_ps(position_y_ + i);
+		__m128 vx = _mm_loadu_ps(velocity_x_ + i);
+		__m128 vy = _mm_loadu_ps(velocity_y_ + i);
+		__m128 angle = _mm_loadu_ps(angle_ + i);
+		__m128 spin = _mm_loadu_ps(spin_ + i);
+		__m128 life = _mm_loadu_ps(life_ + i);
+		__m128 floor_y = _mm_loadu_ps(floor_y_ + i);
+
+		// semi-implicit euler
+		vy = _mm_add_ps(vy, gravity_dt);
+		x = _mm_add_ps(x, _mm_mul_ps(vx, dt));
+		y = _mm_add_ps(y, _mm_mul_ps(vy, dt));
+		angle = _mm_add_ps(angle, _mm_mul_ps(spin, dt));
+		life = _mm_sub_ps(life, dt);
+
+		// particles that have gone through the floor and are moving down are put back on it and bounce
+		__m128 hit = _mm_and_ps(_mm_cmplt_ps(y, floor_y), _mm_cmplt_ps(vy, _mm_setzero_ps()));
+		y = _mm_or_ps(_mm_and_ps(hit, floor_y), _mm_andnot_ps(hit, y));
+		vy = _mm_or_ps(_mm_and_ps(hit, _mm_mul_ps(vy, bounce)), _mm_andnot_ps(hit, vy));
+		vx = _mm_or_ps(_mm_and_ps(hit, _mm_mul_ps(vx, friction)), _mm_andnot_ps(hit, vx));
+		spin = _mm_or_ps(_mm_and_ps(hit, _mm_mul_ps(spin, friction)), _mm_andnot_ps(hit, spin));
+
+		_mm_storeu_ps(position_x_ + i, x);
+		_mm_storeu_ps(position_y_ + i, y);
+		_mm_storeu_ps(velocity_x_ + i, vx);
+		_mm_storeu_ps(velocity_y_ + i, vy);
+		_mm_storeu_ps(angle_ + i, angle);
+		_mm_storeu_ps(spin_ + i, spin);
+		_mm_storeu_ps(life_ + i, life);
+	}
+#else
+	for (; i < count_; ++i)
+	{
+		velocity_y_[i] += gravity_ * time_step;
+		position_x_[i] += velocity_x_[i] * time_step;
+		position_y_[i] += velocity_y_[i] * time_step;
+		angle_[i] += spin_[i] * time_step;
+		life_[i] -= time_step;
+
+		if (position_y_[i] < floor_y_[i] && velocity_y_[i] < 0.0f)
+		{
+			position_y_[i] = floor_y_[i];
+			velocity_y_[i] *= -restitution_;
+			velocity_x_[i] *= friction_;
+			spin_[i] *= friction_;
+		}
+	}
+#endif
+
+	// remove expired particles by moving the last particle into their place
+	i = 0;
+	while (i < count_)
+	{
+		if (life_[i] > 0.0f)
+		{
+			++i;
+			continue;
+		}
+
+		UInt32 last = --count_;
+		position_x_[i] = position_x_[last];
+		position_y_[i] = position_y_[last];
+		position_z_[i] = position_z_[last];
+		velocity_x_[i] = velocity_x_[last];
+		velocity_y_[i] = velocity_y_[last];
+		angle_[i] = angle_[last];
+		spin_[i] = spin_[last];
+		scale_[i] = scale_[last];
+		life_[i] = life_[last];
+		floor_y_[i] = floor_y_[last];
+	}
+}
+
+void ParticleSystem::Clear()
+{
+	count_ = 0;
+}
+
+void ParticleSystem::Render(RenderQueue* render_queue, RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh)
+{
+	transforms_.resize(count_);
+
+	// build each transform directly, a uniform scale and a rotation around z followed by the position
+	for (UInt32 i = 0; i < count_; ++i)
+	{
+		float s = scale_[i] * sinf(angle_[i]);
+		float c = scale_[i] * cosf(angle_[i]);
+
+		gef::Matrix44& transform = transforms_[i];
+		transform.SetIdentity();
+		transform.set_m(0, 0, c);
+		transform.set_m(0, 1, s);
+		transform.set_m(1, 0, -s);
+		transform.set_m(1, 1, c);
+		transform.set_m(2, 2, scale_[i]);
+		transform.SetTranslation(gef::Vector4(position_x_[i], position_y_[i], position_z_[i]));
+	}
+
+	render_queue->AddMeshes(pass, material, mesh, transforms_.empty() ? NULL : &transforms_[0], count_);
+}
@@ -0,0 +1,105 @@
+#ifndef _PARTICLE_SYSTEM_H
+#define _PARTICLE_SYSTEM_H
+
+#include <gef.h>
+#include <maths/vector4.h>
+#include <maths/matrix44.h>
+#include "render_queue.h"
+#include <vector>
+
+namespace gef
+{
+	class Mesh;
+	class Material;
+}
+
+// Describes a burst of particles. Each value with a min and max is picked at random per particle.
+struct ParticleBurst
+{
+	ParticleBurst();
+
+	gef::Vector4 position;
+	gef::Vector4 position_spread;	// random offset in each axis, +/- this amount
+	float velocity_min_x, velocity_max_x;
+	float velocity_min_y, velocity_max_y;
+	float spin_min, spin_max;		// radians per second around z
+	float scale_min, scale_max;
+	float lifetime_min, lifetime_max;
+	float floor_y;					// height of the ground plane the particles bounce on
+	UInt32 count;
+};
+
+// Cosmetic particles simulated on the cpu, with no physics bodies.
+// Particles are stored as a structure of arrays so they are integrated four at a time with SIMD,
+// and bounce off a flat ground plane given when they are emitted.
+class ParticleSystem
+{
+public:
+	/// @brief Constructor.
+	/// @param[in] capacity		The maximum number of live particles. Bursts beyond this are cut short.
+	ParticleSystem(UInt32 capacity = 4096);
+	~ParticleSystem();
+
+	/// @brief Emit a burst of particles.
+	void Emit(const ParticleBurst& burst);
+
+	/// @brief Move every particle on by a time step, bounce them off their ground plane and remove the expired ones.
+	/// @param[in] time_step	The time step in seconds.
+	void Update(float time_step);
+
+	/// @brief Remove every particle.
+	void Clear();
+
+	/// @brief Add a draw for every particle to a render queue. All of the draws share one mesh and material, so they are
+	/// submitted together with no state changes between them.
+	/// @param[in] render_queue	The queue to add to.
+	/// @param[in] pass			The pass to draw the particles in.
+	/// @param[in] material		The material to draw with.
+	/// @param[in] mesh			The mesh to draw for each particle.
+	void Render(RenderQueue* render_queue, RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh);
+
+	UInt32 count() const { return count_; }
+	UInt32 capacity() const { return capacity_; }
+
+	/// @brief The most particles that can be alive at once, up to the capacity. Lowering it cuts new bursts short,
+	/// and leaves the particles already alive to expire on their own.
+	UInt32 limit() const { return limit_; }
+	void set_limit(UInt32 limit) { limit_ = limit < capacity_ ? limit : capacity_; }
+
+	void set_gravity(float gravity) { gravity_ = gravity; }
+	void set_restitution(float restitution) { restitution_ = restitution; }
+	void set_friction(float friction) { friction_ = friction; }
+
+private:
+	float Random(float min, float max);
+
+	// Each array has room for the capacity rounded up to a multiple of 4, so the SIMD loop can run past the last particle.
+	float* position_x_;
+	float* position_y_;
+	float* position_z_;
+	float* velocity_x_;
+	float* velocity_y_;
+	float* angle_;
+	float* spin_;
+	float* scale_;
+	float* life_;
+	float* floor_y_;
+
+	// The memory all of the arrays are allocated from.
+	float* data_;
+
+	UInt32 count_;
+	UInt32 capacity_;
+	UInt32 limit_;
+
+	float gravity_;
+	float restitution_;
+	float friction_;
+
+	UInt32 random_seed_;
+
+	// The transform for each particle, built when rendering.
+	std::vector<gef::Matrix44> transforms_;
+};
+
+#endif // _PARTICLE_SYSTEM_H
@@ -0,0 +1,405 @@
+#include "physics_regions.h"
+#include <thread>
+#include <mutex>
+#include <cmath>
+
+PhysicsRegions::PhysicsRegions() :
+	region_count_(0),
+	min_x_(0.0f),
+	region_width_(1.0f),
+	overlap_margin_(2.0f),
+	handoff_margin_(1.0f),
+	ghost_count_(0),
+	handoff_count_(0)
+{
+	for (int region = 0; region < kMaxRegions; ++region)
+		worlds_[region] = NULL;
+}
+
+PhysicsRegions::~PhysicsRegions()
+{
+	CleanUp();
+}
+
+void PhysicsRegions::Init(LevelArena* arena, const b2Vec2& gravity, float min_x, float max_x, float min_region_width)
+{
+	CleanUp();
+
+	// before any world can be stepped, so no region fills the shared contact table while another reads it
+	InitContactRegistry();
+
+	// one region for each core, leaving one for the renderer
+	int core_count = (int)std::thread::hardware_concurrency();
+	region_count_ = core_count > 2 ? core_count - 1 : 1;
+	if (region_count_ > kMaxRegions)
+		region_count_ = kMaxRegions;
+
+	// but don't cut the level into slivers, every region needs enough in it to be worth a thread
+	float width = max_x > min_x ? max_x - min_x : 0.0f;
+	int widest_count = (int)(width / min_region_width);
+	if (region_count_ > widest_count)
+		region_count_ = widest_count > 1 ? widest_count : 1;
+
+	min_x_ = min_x;
+	region_width_ = width > 0.0f ? width / region_count_ : 1.0f;
+
+	for (int region = 0; region < region_count_; ++region)
+		worlds_[region] = arena->New<b2World>(MEMORY_PHYSICS, gravity);
+
+	for (int region = 1; region < region_count_; ++region)
+		workers_.push_back(std::unique_ptr<WorkerThread>(new WorkerThread()));
+}
+
+void PhysicsRegions::InitContactRegistry()
+{
+	static std::once_flag registry_once;
+	std::call_once(registry_once, []()
+	{
+		// a dynamic box resting on a static one, so the first step creates a polygon contact
+		b2World world(b2Vec2(0.0f, -9.81f));
+		b2PolygonShape box;
+		box.SetAsBox(0.5f, 0.5f);
+
+		b2BodyDef ground_def;
+		world.CreateBody(&ground_def)->CreateFixture(&box, 0.0f);
+
+		b2BodyDef box_def;
+		box_def.type = b2_dynamicBody;
+		box_def.position.Set(0.0f, 0.5f);
+		world.CreateBody(&box_def)->CreateFixture(&box, 1.0f);
+
+		world.Step(1.0f / 60.0f, 1, 1);
+	});
+}
+
+void PhysicsRegions::CleanUp()
+{
+	// the worker threads are idle between steps, so they can be stopped straight away
+	workers_.clear();
+
+	// the worlds and the bodies in them belong to the arena
+	for (int region = 0; region < kMaxRegions; ++region)
+		worlds_[region] = NULL;
+	region_count_ = 0;
+
+	entries_.clear();
+	gathered_pairs_.clear();
+	ghost_count_ = 0;
+	handoff_count_ = 0;
+}
+
+int PhysicsRegions::RegionAt(float x) const
+{
+	int region = (int)floorf((x - min_x_) / region_width_);
+	if (region < 0)
+		return 0;
+	if (region >= region_count_)
+		return region_count_ - 1;
+	return region;
+}
+
+b2World* PhysicsRegions::WorldAt(float x)
+{
+	return worlds_[RegionAt(x)];
+}
+
+void PhysicsRegions::Add(GameObject* object)
+{
+	b2Body* body = object->GetBody();
+
+	Entry entry;
+	entry.object = object;
+	entry.owner = RegionAt(body->GetPosition().x);
+	entry.ghost_count = 0;
+	for (int region = 0; region < kMaxRegions; ++region)
+		entry.ghosts[region] = NULL;
+
+	// work out how far the fixtures reach from the body's origin, whichever way it's rotated
+	// the shapes are used rather than the fixtures' bounds, as disabled bodies don't have any
+	b2Transform origin;
+	origin.SetIdentity();
+	entry.radius = 0.0f;
+	for (b2Fixture* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext())
+	{
+		const b2Shape* shape = fixture->GetShape();
+		for (int32 child = 0; child < shape->GetChildCount(); ++child)
+		{
+			b2AABB bounds;
+			shape->ComputeAABB(&bounds, origin, child);
+			float reach = sqrtf(
+				fmaxf(bounds.lowerBound.x * bounds.lowerBound.x, bounds.upperBound.x * bounds.upperBound.x) +
+				fmaxf(bounds.lowerBound.y * bounds.lowerBound.y, bounds.upperBound.y * bounds.upperBound.y));
+			if (reach > entry.radius)
+				entry.radius = reach;
+		}
+	}
+
+	entries_.push_back(entry);
+
+	// create the ghosts now, so objects near a boundary collide from the first step
+	UpdateGhosts(entries_.back());
+}
+
+void PhysicsRegions::Step(float time_step, int32 velocity_iterations, int32 position_iterations)
+{
+	// bodies can only be created and destroyed while no world is stepping, so move objects between regions first
+	handoff_count_ = 0;
+	if (region_count_ > 1)
+	{
+		for (size_t entry_num = 0; entry_num < entries_.size(); ++entry_num)
+		{
+			HandOff(entries_[entry_num]);
+			UpdateGhosts(entries_[entry_num]);
+		}
+	}
+
+	// the worlds share no bodies or allocators, so each can be stepped on its own thread
+	// box2d's globals are shared though: the contact function table, which InitContactRegistry filled before any
+	// region was stepped so it is only read here, and the b2_gjk and b2_toi statistics counters, which every world
+	// increments without synchronisation. nothing reads the counters, so their values are meaningless while regions
+	// are stepped in parallel, but they don't affect the simulation
+	for (int region = 1; region < region_count_; ++region)
+	{
+		b2World* world = worlds_[region];
+		workers_[region - 1]->Kick([world, time_step, velocity_iterations, position_iterations]()
+		{
+			world->Step(time_step, velocity_iterations, position_iterations);
+		});
+	}
+
+	if (region_count_ > 0)
+		worlds_[0]->Step(time_step, velocity_iterations, position_iterations);
+
+	for (size_t worker_num = 0; worker_num < workers_.size(); ++worker_num)
+		workers_[worker_num]->Wait();
+}
+
+void PhysicsRegions::HandOff(Entry& entry)
+{
+	b2Body* primary = entry.object->GetBody();
+	float x = primary->GetPosition().x;
+
+	// stay in the owner region until the handoff margin is crossed, so an object on a boundary doesn't swap every step
+	// there is nothing past the first and last regions to hand off to
+	float start = min_x_ + entry.owner * region_width_;
+	float end = start + region_width_;
+	bool past_start = entry.owner > 0 && x < start - handoff_margin_;
+	bool past_end = entry.owner < region_count_ - 1 && x > end + handoff_margin_;
+	if (!past_start && !past_end)
+		return;
+
+	int new_owner = RegionAt(x);
+	b2BodyType type = primary->GetType();
+
+	// the ghost in the new region becomes the primary
+	// there may not be one if the object was teleported, e.g. when the player respawns
+	b2Body* body = entry.ghosts[new_owner];
+	if (body)
+	{
+		entry.ghosts[new_owner] = NULL;
+		entry.ghost_count--;
+		ghost_count_--;
+		body->SetType(type);
+		SyncBody(primary, body);
+	}
+	else
+	{
+		body = CopyBody(primary, worlds_[new_owner], type);
+	}
+
+	// the old primary becomes a ghost, UpdateGhosts destroys it if the object has moved out of the overlap margin
+	primary->SetType(GhostType(type));
+	entry.ghosts[entry.owner] = primary;
+	entry.ghost_count++;
+	ghost_count_++;
+
+	entry.owner = new_owner;
+	entry.object->set_body(body);
+	handoff_count_++;
+}
+
+void PhysicsRegions::UpdateGhosts(Entry& entry)
+{
+	b2Body* primary = entry.object->GetBody();
+	float x = primary->GetPosition().x;
+	int first = RegionAt(x - entry.radius - overlap_margin_);
+	int last = RegionAt(x + entry.radius + overlap_margin_);
+
+	// most objects are nowhere near a boundary
+	if (entry.ghost_count == 0 && first == entry.owner && last == entry.owner)
+		return;
+
+	for (int region = 0; region < region_count_; ++region)
+	{
+		if (region == entry.owner)
+			continue;
+
+		b2Body*& ghost = entry.ghosts[region];
+		if (region >= first && region <= last)
+		{
+			if (ghost)
+			{
+				SyncBody(primary, ghost);
+			}
+			else
+			{
+				ghost = CopyBody(primary, worlds_[region], GhostType(primary->GetType()));
+				entry.ghost_count++;
+				ghost_count_++;
+			}
+		}
+		else if (ghost)
+		{
+			worlds_[region]->DestroyBody(ghost);
+			ghost = NULL;
+			entry.ghost_count--;
+			ghost_count_--;
+		}
+	}
+}
+
+b2Body* PhysicsRegions::CopyBody(b2Body* source, b2World* world, b2BodyType type)
+{
+	b2BodyDef body_def;
+	body_def.type = type;
+	body_def.position = source->GetPosition();
+	body_def.angle = source->GetAngle();
+	body_def.linearVelocity = source->GetLinearVelocity();
+	body_def.angularVelocity = source->GetAngularVelocity();
+	body_def.linearDamping = source->GetLinearDamping();
+	body_def.angularDamping = source->GetAngularDamping();
+	body_def.allowSleep = source->IsSleepingAllowed();
+	body_def.awake = source->IsAwake();
+	body_def.fixedRotation = source->IsFixedRotation();
+	body_def.bullet = source->IsBullet();
+	body_def.enabled = source->IsEnabled();
+	body_def.gravityScale = source->GetGravityScale();
+	body_def.userData = source->GetUserData();
+	b2Body* body = world->CreateBody(&body_def);
+
+	// fixtures are added to the front of a body's list, so copy them last to first to keep the lists in the same order
+	std::vector<b2Fixture*> fixtures;
+	for (b2Fixture* fixture = source->GetFixtureList(); fixture; fixture = fixture->GetNext())
+		fixtures.push_back(fixture);
+
+	for (size_t fixture_num = fixtures.size(); fixture_num > 0; --fixture_num)
+	{
+		b2Fixture* fixture = fixtures[fixture_num - 1];
+		b2FixtureDef fixture_def;
+		fixture_def.shape = fixture->GetShape();
+		fixture_def.density = fixture->GetDensity();
+		fixture_def.friction = fixture->GetFriction();
+		fixture_def.restitution = fixture->GetRestitution();
+		fixture_def.restitutionThreshold = fixture->GetRestitutionThreshold();
+		fixture_def.isSensor = fixture->IsSensor();
+		fixture_def.filter = fixture->GetFilterData();
+		fixture_def.userData = fixture->GetUserData();
+		body->CreateFixture(&fixture_def);
+	}
+
+	return body;
+}
+
+void PhysicsRegions::SyncBody(b2Body* source, b2Body* target)
+{
+	// moving a body refilters its contacts, so only move it if it has moved
+	const b2Vec2& position = source->GetPosition();
+	if (position.x != target->GetPosition().x || position.y != target->GetPosition().y || source->GetAngle() != target->GetAngle())
+		target->SetTransform(position, source->GetAngle());
+
+	// ghosts of static bodies stay static, e.g. when a crusher lands
+	if (source->GetType() == b2_staticBody && target->GetType() != b2_staticBody)
+		target->SetType(b2_staticBody);
+	else if (source->GetType() != b2_staticBody && target->GetType() == b2_staticBody)
+		target->SetType(b2_kinematicBody);
+
+	if (target->GetType() != b2_staticBody)
+	{
+		target->SetLinearVelocity(source->GetLinearVelocity());
+		target->SetAngularVelocity(source->GetAngularVelocity());
+		target->SetAwake(source->IsAwake());
+	}
+
+	target->SetEnabled(source->IsEnabled());
+
+	// gameplay turns objects into sensors so they fall through the level, e.g. when an enemy dies
+	b2Fixture* target_fixture = target->GetFixtureList();
+	for (b2Fixture* fixture = source->GetFixtureList(); fixture && target_fixture; fixture = fixture->GetNext())
+	{
+		if (target_fixture->IsSensor() != fixture->IsSensor())
+			target_fixture->SetSensor(fixture->IsSensor());
+		target_fixture = target_fixture->GetNext();
+	}
+}
+
+b2BodyType PhysicsRegions::GhostType(b2BodyType type)
+{
+	return type == b2_staticBody ? b2_staticBody : b2_kinematicBody;
+}
+
+void PhysicsRegions::GatherContacts(std::vector<b2Contact*>& contacts)
+{
+	contacts.clear();
+	gathered_pairs_.clear();
+
+	for (int region = 0; region < region_count_; ++region)
+	{
+		for (b2Contact* contact = worlds_[region]->GetContactList(); contact; contact = contact->GetNext())
+		{
+			b2Body* body_a = contact->GetFixtureA()->GetBody();
+			b2Body* body_b = contact->GetFixtureB()->GetBody();
+			GameObject* object_a = reinterpret_cast<GameObject*>(body_a->GetUserData().pointer);
+			GameObject* object_b = reinterpret_cast<GameObject*>(body_b->GetUserData().pointer);
+			bool ghost_a = object_a && object_a->GetBody() != body_a;
+			bool ghost_b = object_b && object_b->GetBody() != body_b;
+
+			// two ghosts are both primaries somewhere else, and any contact between them is gathered there
+			if (ghost_a && ghost_b)
+				continue;
+
+			// a primary and a ghost may also be touching the other way round in the ghost's region, so only keep the first
+			if (ghost_a || ghost_b)
+			{
+				if (!contact->IsTouching())
+					continue;
+
+				std::pair<const void*, const void*> pair = object_a < object_b ? std::make_pair((const void*)object_a, (const void*)object_b) : std::make_pair((const void*)object_b, (const void*)object_a);
+				if (!gathered_pairs_.insert(pair).second)
+					continue;
+			}
+
+			contacts.push_back(contact);
+		}
+	}
+}
+
+size_t PhysicsRegions::PairHash::operator()(const std::pair<const void*, const void*>& pair) const
+{
+	size_t a = reinterpret_cast<size_t>(pair.first);
+	size_t b = reinterpret_cast<size_t>(pair.second);
+	return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+}
+
+int PhysicsRegions::body_count() const
+{
+	int count = 0;
+	for (int region = 0; region < region_count_; ++region)
+		count += worlds_[region]->GetBodyCount();
+	return count;
+}
+
+int PhysicsRegions::proxy_count() const
+{
+	int count = 0;
+	for (int region = 0; region < region_count_; ++region)
+		count += worlds_[region]->GetProxyCount();
+	return count;
+}
+
+int PhysicsRegions::contact_count() const
+{
+	int count = 0;
+	for (int region = 0; region < region_count_; ++region)
+		count += worlds_[region]->GetContactCount();
+	return count;
+}
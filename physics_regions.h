@@ -0,0 +1,131 @@
+#ifndef _PHYSICS_REGIONS_H
+#define _PHYSICS_REGIONS_H
+
+#include "game_object.h"
+#include "level_arena.h"
+#include "worker_thread.h"
+#include <box2d/Box2D.h>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Splits a level into regions along x, each simulated by its own b2World, so the regions can be stepped in parallel.
+// Every object has one primary body, in the world of the region it is in. Objects within the overlap margin of
+// another region also get a ghost body in that region's world, which copies the primary before each step, so objects
+// either side of a boundary still collide. Ghosts of moving bodies are kinematic: they push bodies in the other region
+// but aren't pushed back. Once an object is further than the handoff margin into another region, its body there
+// becomes the primary, and the old primary becomes a ghost.
+class PhysicsRegions
+{
+public:
+	/// @brief The most regions a level is split into.
+	static const int kMaxRegions = 8;
+
+	PhysicsRegions();
+	~PhysicsRegions();
+
+	/// @brief Create a world for each region. There is a region for each core not used for rendering, as long as
+	/// each region is at least min_region_width wide.
+	/// @param[in] arena			The arena the worlds are allocated from. They are destroyed when it is released.
+	/// @param[in] gravity			The gravity in every world.
+	/// @param[in] min_x			The left of the level. Anything further left is in the first region.
+	/// @param[in] max_x			The right of the level. Anything further right is in the last region.
+	/// @param[in] min_region_width	The narrowest a region can be.
+	void Init(LevelArena* arena, const b2Vec2& gravity, float min_x, float max_x, float min_region_width);
+
+	/// @brief Forget the worlds and objects and stop the worker threads. Call before the arena is released.
+	void CleanUp();
+
+	/// @brief The world of the region containing x. Create an object's body in it, then pass the object to Add.
+	b2World* WorldAt(float x);
+
+	/// @brief Start tracking an object. Its body and fixtures must have been created.
+	void Add(GameObject* object);
+
+	/// @brief Hand off objects that have moved into another region and update their ghosts, then step every region's
+	/// world in parallel.
+	void Step(float time_step, int32 velocity_iterations, int32 position_iterations);
+
+	/// @brief Collect the contacts from every region for the step just taken. Contacts between two ghosts are left
+	/// out, and a pair of objects touching in more than one region is only included once.
+	void GatherContacts(std::vector<b2Contact*>& contacts);
+
+	/// @brief The overlap margin, how far past a boundary objects are copied into the next region.
+	float overlap_margin() const { return overlap_margin_; }
+	void set_overlap_margin(float margin) { overlap_margin_ = margin; }
+
+	/// @brief The handoff margin, how far past a boundary an object goes before it belongs to the next region.
+	/// Should be less than the overlap margin, so there is already a ghost to hand off to.
+	float handoff_margin() const { return handoff_margin_; }
+	void set_handoff_margin(float margin) { handoff_margin_ = margin; }
+
+	int region_count() const { return region_count_; }
+	b2World* world(int region) { return worlds_[region]; }
+
+	/// @brief Totals across every region. The body count includes ghosts.
+	int body_count() const;
+	int proxy_count() const;
+	int contact_count() const;
+	int ghost_count() const { return ghost_count_; }
+
+	/// @brief The number of objects that moved into another region during the last step.
+	int handoff_count() const { return handoff_count_; }
+
+private:
+	// An object being tracked, and its ghost body in each region. The owner region's entry is always NULL.
+	struct Entry
+	{
+		GameObject* object;
+		float radius;
+		int owner;
+		int ghost_count;
+		b2Body* ghosts[kMaxRegions];
+	};
+
+	// Hashes a pair of objects, to find pairs that touched in more than one region.
+	struct PairHash
+	{
+		size_t operator()(const std::pair<const void*, const void*>& pair) const;
+	};
+
+	int RegionAt(float x) const;
+
+	// Moves the object's primary body into the region it is now in, if it's past the handoff margin.
+	void HandOff(Entry& entry);
+
+	// Creates, updates or destroys the object's ghosts depending on which regions it overlaps.
+	void UpdateGhosts(Entry& entry);
+
+	// Box2D fills its table of contact functions the first time any world creates a contact, and the table is shared
+	// by every world. Makes a contact in a throwaway world, once, so the table is filled before any region is stepped.
+	static void InitContactRegistry();
+
+	// Creates a copy of a body and its fixtures in another world.
+	static b2Body* CopyBody(b2Body* source, b2World* world, b2BodyType type);
+
+	// Copies the state gameplay changes from one body to another.
+	static void SyncBody(b2Body* source, b2Body* target);
+
+	// Ghosts of static bodies stay static, everything else is kinematic.
+	static b2BodyType GhostType(b2BodyType type);
+
+	b2World* worlds_[kMaxRegions];
+	int region_count_;
+	float min_x_;
+	float region_width_;
+	float overlap_margin_;
+	float handoff_margin_;
+
+	std::vector<Entry> entries_;
+	int ghost_count_;
+	int handoff_count_;
+
+	// A thread for every region but the first, which is stepped on the calling thread.
+	std::vector<std::unique_ptr<WorkerThread>> workers_;
+
+	// The pairs with a ghost that have already been gathered this step.
+	std::unordered_set<std::pair<const void*, const void*>, PairHash> gathered_pairs_;
+};
+
+#endif // _PHYSICS_REGIONS_H
@@ -0,0 +1,94 @@
+#include "pose_cache.h"
+#include "anim_clip.h"
+#include <graphics/skinned_mesh_instance.h>
+#include <cmath>
+
+PoseCache::PoseCache() :
+	skinning_(NULL),
+	pose_count_(0),
+	request_count_(0),
+	time_step_(1.0f / 30.0f),
+	clock_(0.0f)
+{
+}
+
+PoseCache::~PoseCache()
+{
+	CleanUp();
+}
+
+void PoseCache::Init(const gef::Skeleton& skeleton)
+{
+	CleanUp();
+	skinning_ = new gef::SkinnedMeshInstance(skeleton);
+}
+
+void PoseCache::CleanUp()
+{
+	delete skinning_;
+	skinning_ = NULL;
+	poses_.clear();
+	pose_lookup_.clear();
+	clip_ids_.clear();
+	pose_count_ = 0;
+	request_count_ = 0;
+	clock_ = 0.0f;
+}
+
+void PoseCache::NewFrame(float frame_time)
+{
+	pose_lookup_.clear();
+	pose_count_ = 0;
+	request_count_ = 0;
+	clock_ += frame_time;
+}
+
+float PoseCache::LoopTime(const AnimClip* clip, float phase) const
+{
+	if (!clip || clip->duration() <= 0.0f)
+		return 0.0f;
+
+	float duration = clip->duration();
+	return fmodf(clock_ + phase * duration, duration);
+}
+
+const std::vector<gef::Matrix44>& PoseCache::BoneMatrices(const AnimClip* clip, float anim_time, UInt32 step_multiple)
+{
+	request_count_++;
+
+	// round the time to the nearest step, or multiple of steps, and build a key from it and the clip
+	if (step_multiple < 1)
+		step_multiple = 1;
+	float rounding = time_step_ * step_multiple;
+	UInt32 step = anim_time > 0.0f ? (UInt32)(anim_time / rounding + 0.5f) * step_multiple : 0;
+	UInt32 clip_id = clip_ids_.insert(std::make_pair(clip, (UInt32)clip_ids_.size())).first->second;
+	UInt64 key = ((UInt64)clip_id << 32) | step;
+
+	std::pair<std::unordered_map<UInt64, UInt32>::iterator, bool> lookup = pose_lookup_.insert(std::make_pair(key, pose_count_));
+	if (!lookup.second)
+		return poses_[lookup.first->second].bone_matrices;
+
+	// first time this pose has been asked for this frame, so sample it into the next free slot
+	if (pose_count_ == poses_.size())
+		poses_.push_back(Pose());
+	Pose& pose = poses_[pose_count_++];
+
+	const gef::SkeletonPose& bind_pose = skinning_->bind_pose();
+	if (clip)
+	{
+		// sample at the rounded time rather than the first actor's time, so the pose doesn't depend on which actor asked first
+		float sample_time = step * time_step_;
+		if (sample_time > clip->duration())
+			sample_time = clip->duration();
+		clip->Sample(pose.pose, bind_pose, sample_time + clip->start_time());
+	}
+	else
+	{
+		pose.pose = bind_pose;
+	}
+
+	skinning_->UpdateBoneMatrices(pose.pose);
+	pose.bone_matrices = skinning_->bone_matrices();
+
+	return pose.bone_matrices;
+}
@@ -0,0 +1,89 @@
+#ifndef _POSE_CACHE_H
+#define _POSE_CACHE_H
+
+#include <gef.h>
+#include <animation/skeleton.h>
+#include <maths/matrix44.h>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+namespace gef
+{
+	class SkinnedMeshInstance;
+}
+
+class AnimClip;
+
+// Shares sampled poses between actors that use the same skeleton.
+// Playback times are rounded to a fixed step, so every actor playing the same clip at the same rounded time gets
+// the same pose and bone matrices. Each distinct (clip, time) pair is only sampled once a frame, so the cost of
+// animating a crowd grows with the number of distinct poses rather than the number of actors.
+class PoseCache
+{
+public:
+	PoseCache();
+	~PoseCache();
+
+	/// @brief Set up the cache for a skeleton. Every actor using the cache must share it.
+	/// @param[in] skeleton		The skeleton being animated.
+	void Init(const gef::Skeleton& skeleton);
+
+	/// @brief Free everything the cache holds.
+	void CleanUp();
+
+	/// @brief Forget the poses sampled last frame and move the shared clock on. Call once a frame before any actor asks for a pose.
+	/// @param[in] frame_time	The time since the last frame.
+	void NewFrame(float frame_time);
+
+	/// @brief The time every actor using the cache plays its looping clips from. Actors that start their clips from
+	/// this clock, rather than from when they last changed clip, stay in step and share the same poses.
+	float clock() const { return clock_; }
+
+	/// @brief The playback time of a looping clip on the shared clock, offset by a fraction of the clip's duration.
+	/// @param[in] clip		The clip being played.
+	/// @param[in] phase	How far into the clip to be at time zero, as a fraction of its duration.
+	float LoopTime(const AnimClip* clip, float phase) const;
+
+	/// @brief Get the bone matrices for a clip at a playback time, sampling the clip if no one has asked for that pose this frame.
+	/// The matrices stay valid until the next call to NewFrame.
+	/// @param[in] clip			The clip being played. NULL gives the bind pose.
+	/// @param[in] anim_time	The playback time, not including the clip's start time.
+	/// @param[in] step_multiple	Round to this many steps rather than one, for actors that can animate less smoothly.
+	/// Their poses land on the same steps as everyone else's, so they still share them.
+	const std::vector<gef::Matrix44>& BoneMatrices(const AnimClip* clip, float anim_time, UInt32 step_multiple = 1);
+
+	/// @brief The step playback times are rounded to. Smaller steps look smoother but share fewer poses.
+	float time_step() const { return time_step_; }
+	void set_time_step(float time_step) { time_step_ = time_step; }
+
+	/// @brief The number of poses sampled, and the number asked for, since NewFrame.
+	UInt32 pose_count() const { return pose_count_; }
+	UInt32 request_count() const { return request_count_; }
+
+private:
+	struct Pose
+	{
+		gef::SkeletonPose pose;
+		std::vector<gef::Matrix44> bone_matrices;
+	};
+
+	// Used to turn a sampled pose into bone matrices, and for the bind pose.
+	gef::SkinnedMeshInstance* skinning_;
+
+	// The poses. A deque so they don't move as more are added, and kept between frames so they keep their memory.
+	std::deque<Pose> poses_;
+	UInt32 pose_count_;
+	UInt32 request_count_;
+
+	// The pose used by each (clip id, rounded time) this frame.
+	std::unordered_map<UInt64, UInt32> pose_lookup_;
+
+	// Small ids for the clips, so the clip and time fit in one key.
+	std::unordered_map<const AnimClip*, UInt32> clip_ids_;
+
+	float time_step_;
+	float clock_;
+};
+
+#endif // _POSE_CACHE_H
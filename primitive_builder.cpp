@@ -53,6 +53,15 @@ void PrimitiveBuilder::CleanUp()
 	default_cube_mesh_ = NULL;
 }
 
+//
+// BoxMeshByteSize
+//
+size_t PrimitiveBuilder::BoxMeshByteSize()
+{
+	// 24 vertices and 36 indices, see CreateBoxMesh
+	return sizeof(gef::Mesh) + 4 * 6 * sizeof(gef::Mesh::Vertex) + 6 * 6 * sizeof(Int32);
+}
+
 //
 // CreateBoxMesh
 //
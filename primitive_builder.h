@@ -34,6 +34,10 @@ public:
 	/// @param[in] materials	an array of Material pointers. One for each face. 6 in total.
 	gef::Mesh* CreateBoxMesh(const gef::Vector4& half_size, gef::Vector4 centre = gef::Vector4(0.0f, 0.0f, 0.0f), gef::Material** materials = NULL);
 
+	/// @brief Get the size of the vertex and index data in a mesh created by CreateBoxMesh.
+	/// @return The size in bytes.
+	static size_t BoxMeshByteSize();
+
 
 	/// @brief Creates a sphere shaped mesh
 	/// @return The mesh created
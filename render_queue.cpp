@@ -0,0 +1,187 @@
+#include "render_queue.h"
+#include <graphics/renderer_3d.h>
+#include <graphics/skinned_mesh_instance.h>
+
+RenderQueue::RenderQueue() :
+	skinned_count_(0),
+	material_changes_(0)
+{
+}
+
+void RenderQueue::Clear()
+{
+	commands_.clear();
+	entries_.clear();
+	skinned_count_ = 0;
+}
+
+void RenderQueue::Reset()
+{
+	Clear();
+	material_ids_.clear();
+	mesh_ids_.clear();
+	bone_matrices_.clear();
+	material_changes_ = 0;
+}
+
+UInt32 RenderQueue::MakeKey(RENDER_PASS pass, const gef::Material* material, const void* mesh)
+{
+	// id 0 is kept for no material, so draws using the mesh's own materials go first in their pass
+	UInt32 material_id = 0;
+	if (material)
+		material_id = material_ids_.insert(std::make_pair(static_cast<const void*>(material), (UInt32)material_ids_.size() + 1)).first->second;
+
+	UInt32 mesh_id = mesh_ids_.insert(std::make_pair(mesh, (UInt32)mesh_ids_.size())).first->second;
+
+	return ((UInt32)pass << 28) | ((material_id & 0xfff) << 16) | (mesh_id & 0xffff);
+}
+
+void RenderQueue::AddMesh(RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh, const gef::Matrix44& transform)
+{
+	if (!mesh)
+		return;
+
+	SortEntry entry;
+	entry.key = MakeKey(pass, material, mesh);
+	entry.command = (UInt32)commands_.size();
+	entries_.push_back(entry);
+
+	Command command;
+	command.transform = transform;
+	command.material = material;
+	command.mesh = mesh;
+	command.bones = -1;
+	commands_.push_back(command);
+}
+
+void RenderQueue::AddMeshes(RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh, const gef::Matrix44* transforms, UInt32 count)
+{
+	if (!mesh || count == 0)
+		return;
+
+	const UInt32 key = MakeKey(pass, material, mesh);
+
+	for (UInt32 draw_num = 0; draw_num < count; ++draw_num)
+	{
+		SortEntry entry;
+		entry.key = key;
+		entry.command = (UInt32)commands_.size();
+		entries_.push_back(entry);
+
+		Command command;
+		command.transform = transforms[draw_num];
+		command.material = material;
+		command.mesh = mesh;
+		command.bones = -1;
+		commands_.push_back(command);
+	}
+}
+
+void RenderQueue::AddSkinnedMesh(RENDER_PASS pass, const gef::Material* material, const gef::SkinnedMeshInstance* instance)
+{
+	if (!instance)
+		return;
+
+	AddSkinnedMesh(pass, material, instance->mesh(), instance->transform(), instance->bone_matrices());
+}
+
+void RenderQueue::AddSkinnedMesh(RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh, const gef::Matrix44& transform, const std::vector<gef::Matrix44>& bone_matrices)
+{
+	if (!mesh)
+		return;
+
+	SortEntry entry;
+	entry.key = MakeKey(pass, material, mesh);
+	entry.command = (UInt32)commands_.size();
+	entries_.push_back(entry);
+
+	Command command;
+	command.transform = transform;
+	command.material = material;
+	command.mesh = mesh;
+	command.bones = (Int32)skinned_count_;
+	commands_.push_back(command);
+
+	// copy the bone matrices rather than keeping a pointer, so the queue doesn't depend on the actor after this
+	if (skinned_count_ == bone_matrices_.size())
+		bone_matrices_.resize(skinned_count_ + 1);
+	bone_matrices_[skinned_count_++] = bone_matrices;
+}
+
+void RenderQueue::Sort()
+{
+	const size_t count = entries_.size();
+	if (count < 2)
+		return;
+
+	sort_buffer_.resize(count);
+
+	SortEntry* source = &entries_[0];
+	SortEntry* dest = &sort_buffer_[0];
+
+	// least significant digit radix sort, a byte at a time. It's stable, so draws with equal keys keep the order they were added in
+	for (UInt32 shift = 0; shift < 32; shift += 8)
+	{
+		UInt32 counts[256] = { 0 };
+		for (size_t entry_num = 0; entry_num < count; ++entry_num)
+			counts[(source[entry_num].key >> shift) & 0xff]++;
+
+		// skip the byte if every key has the same value for it, which is common as there are few passes and materials
+		if (counts[(source[0].key >> shift) & 0xff] == count)
+			continue;
+
+		UInt32 offset = 0;
+		for (UInt32 digit = 0; digit < 256; ++digit)
+		{
+			UInt32 digit_count = counts[digit];
+			counts[digit] = offset;
+			offset += digit_count;
+		}
+
+		for (size_t entry_num = 0; entry_num < count; ++entry_num)
+			dest[counts[(source[entry_num].key >> shift) & 0xff]++] = source[entry_num];
+
+		SortEntry* temp = source;
+		source = dest;
+		dest = temp;
+	}
+
+	// make sure the sorted entries end up in entries_
+	if (source != &entries_[0])
+		entries_.swap(sort_buffer_);
+}
+
+void RenderQueue::Submit(gef::Renderer3D* renderer_3d) const
+{
+	material_changes_ = 0;
+
+	// start with no override so the first draw always sets its material
+	const gef::Material* current_material = NULL;
+	renderer_3d->set_override_material(NULL);
+
+	for (size_t entry_num = 0; entry_num < entries_.size(); ++entry_num)
+	{
+		const Command& command = commands_[entries_[entry_num].command];
+
+		if (command.material != current_material)
+		{
+			renderer_3d->set_override_material(command.material);
+			current_material = command.material;
+			material_changes_++;
+		}
+
+		// both paths honour the override material, as the mesh instance draws the queue replaced did
+		if (command.bones >= 0)
+		{
+			skinned_draw_.set_mesh(command.mesh);
+			skinned_draw_.set_transform(command.transform);
+			renderer_3d->DrawSkinnedMesh(skinned_draw_, bone_matrices_[command.bones], true);
+		}
+		else
+			renderer_3d->DrawMesh(*command.mesh, command.transform, true);
+	}
+
+	// leave the renderer as it was found
+	if (current_material)
+		renderer_3d->set_override_material(NULL);
+}
@@ -0,0 +1,125 @@
+#ifndef _RENDER_QUEUE_H
+#define _RENDER_QUEUE_H
+
+#include <gef.h>
+#include <maths/matrix44.h>
+#include <graphics/mesh_instance.h>
+#include <vector>
+#include <unordered_map>
+
+namespace gef
+{
+	class Mesh;
+	class Material;
+	class Renderer3D;
+	class SkinnedMeshInstance;
+}
+
+// The passes draws are grouped into. Passes are drawn in this order.
+enum RENDER_PASS
+{
+	PASS_OPAQUE,
+	PASS_SKINNED,
+	PASS_ALPHA,
+	PASS_COUNT
+};
+
+// A list of draws that is filled each frame, sorted so draws sharing a material and mesh are together, then submitted.
+// The override material is only changed when it differs from the previous draw, so the number of material changes
+// is bounded by the number of distinct materials in each pass rather than the number of draws.
+class RenderQueue
+{
+public:
+	RenderQueue();
+
+	/// @brief Remove all of the draws, ready for the next frame.
+	void Clear();
+
+	/// @brief Forget the ids given to materials and meshes. Call when the meshes and materials are freed.
+	void Reset();
+
+	/// @brief Add a draw of a mesh.
+	/// @param[in] pass			The pass to draw the mesh in.
+	/// @param[in] material		The override material to draw with. NULL draws with the mesh's own materials.
+	/// @param[in] mesh			The mesh to draw.
+	/// @param[in] transform	The mesh's world transform.
+	void AddMesh(RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh, const gef::Matrix44& transform);
+
+	/// @brief Add a batch of draws of the same mesh with the same material, e.g. particles.
+	/// The key is only built once, and the draws sort together so they are submitted back to back with no state changes.
+	/// @param[in] pass			The pass to draw the meshes in.
+	/// @param[in] material		The override material to draw with.
+	/// @param[in] mesh			The mesh to draw.
+	/// @param[in] transforms	Array of world transforms, one per draw.
+	/// @param[in] count		The number of transforms.
+	void AddMeshes(RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh, const gef::Matrix44* transforms, UInt32 count);
+
+	/// @brief Add a draw of a skinned mesh. The transform and bone matrices are copied, so the instance can
+	/// carry on animating, or be freed, before Submit is called.
+	/// @param[in] pass			The pass to draw the mesh in.
+	/// @param[in] material		The override material to draw with. NULL draws with the mesh's own materials.
+	/// @param[in] instance		The skinned mesh instance, its bone matrices are used when it is drawn.
+	void AddSkinnedMesh(RENDER_PASS pass, const gef::Material* material, const gef::SkinnedMeshInstance* instance);
+
+	/// @brief Add a draw of a skinned mesh with bone matrices that don't belong to an instance, e.g. from a PoseCache.
+	/// @param[in] pass				The pass to draw the mesh in.
+	/// @param[in] material			The override material to draw with. NULL draws with the mesh's own materials.
+	/// @param[in] mesh				The skinned mesh to draw.
+	/// @param[in] transform		The mesh's world transform.
+	/// @param[in] bone_matrices	The bone matrices to skin the mesh with. They are copied.
+	void AddSkinnedMesh(RENDER_PASS pass, const gef::Material* material, const gef::Mesh* mesh, const gef::Matrix44& transform, const std::vector<gef::Matrix44>& bone_matrices);
+
+	/// @brief Sort the draws by pass, then material, then mesh.
+	void Sort();
+
+	/// @brief Draw everything in sorted order. Must be called between the renderer's Begin and End.
+	/// @param[in] renderer_3d	The renderer to draw with.
+	void Submit(gef::Renderer3D* renderer_3d) const;
+
+	/// @brief The number of draws in the queue.
+	UInt32 draw_count() const { return (UInt32)commands_.size(); }
+
+	/// @brief The number of times the override material was changed by the last Submit.
+	UInt32 material_changes() const { return material_changes_; }
+
+private:
+	struct Command
+	{
+		gef::Matrix44 transform;
+		const gef::Material* material;
+		const gef::Mesh* mesh;
+		// Index into bone_matrices_ for skinned draws, or -1.
+		Int32 bones;
+	};
+
+	// A sort key and the index of the command it belongs to.
+	struct SortEntry
+	{
+		UInt32 key;
+		UInt32 command;
+	};
+
+	// Build a key with the pass in the top 4 bits, then 12 bits of material id and 16 bits of mesh id.
+	UInt32 MakeKey(RENDER_PASS pass, const gef::Material* material, const void* mesh);
+
+	std::vector<Command> commands_;
+	std::vector<SortEntry> entries_;
+	std::vector<SortEntry> sort_buffer_;
+
+	// Copies of each skinned draw's bone matrices. Kept between frames so the vectors keep their memory,
+	// skinned_count_ of them are in use.
+	std::vector<std::vector<gef::Matrix44> > bone_matrices_;
+	UInt32 skinned_count_;
+
+	// Instance used to pass skinned draws to the renderer. Submit doesn't change what is queued, so it can be const.
+	mutable gef::MeshInstance skinned_draw_;
+
+	// Small ids for the materials and meshes that have been drawn, so they fit in the sort key.
+	// Ids are handed out in the order things are first drawn, so the first frame's order is kept.
+	std::unordered_map<const void*, UInt32> material_ids_;
+	std::unordered_map<const void*, UInt32> mesh_ids_;
+
+	mutable UInt32 material_changes_;
+};
+
+#endif // _RENDER_QUEUE_H
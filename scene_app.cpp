@@ -9,6 +9,11 @@
 #include <input/sony_controller_input_manager.h>
 #include <graphics/sprite.h>
 #include "load_texture.h"
+#include "asset_cooker.h"
+#include "memory_tracker.h"
+#ifdef STRESS_TEST
+#include "stress_test.h"
+#endif
 
 SceneApp::SceneApp(gef::Platform& platform) :
 	Application(platform),
@@ -18,12 +23,19 @@ SceneApp::SceneApp(gef::Platform& platform) :
 	input_manager_(NULL),
 	font_(NULL),
 	world_(NULL),
-	audio_manager_(NULL)
+	audio_manager_(NULL),
+	audio_bytes_(0),
+	render_state_(State::SPLASH)
 {
 }
 
 void SceneApp::Init()
 {
+#ifdef COOK_ASSETS
+	// Cook every asset into a blob before anything is loaded, so this run and every run after it uses the cooked data.
+	AssetCooker::CookAll(platform_);
+#endif
+
 	// Create the sprite renderer.
 	sprite_renderer_ = gef::SpriteRenderer::Create(platform_);
 
@@ -34,6 +46,9 @@ void SceneApp::Init()
 	{
 		input_manager_->touch_manager()->EnablePanel(0);
 	}
+
+	// Start the input thread. It only polls while a level is being played, the menus use the input manager themselves.
+	input_service_.Start(input_manager_);
 		
 	// Create the audio manager.
 	audio_manager_ = gef::AudioManager::Create();
@@ -56,14 +71,30 @@ void SceneApp::Init()
 
 	// Creates objects for each of the states and passes through the relevant pointers as arguments.
 	splash_.Init(sprite_renderer_, font_, &platform_, &game_state_);
-	main_menu_.Init(sprite_renderer_, font_, &platform_, &game_state_, input_manager_, audio_manager_, &level_);
-	level_.Init(sprite_renderer_, font_, &platform_, &game_state_, input_manager_, audio_manager_, &main_menu_, renderer_3d_, primitive_builder_);
-	pause_menu_.Init(sprite_renderer_, font_, &platform_, &game_state_, input_manager_, audio_manager_, &level_, &main_menu_);
-	end_screen_.Init(sprite_renderer_, font_, &platform_, &game_state_, input_manager_, audio_manager_, &level_, &main_menu_);
+	main_menu_.Init(sprite_renderer_, font_, &platform_, &game_state_, input_manager_, audio_manager_, &level_host_);
+#ifdef STRESS_TEST
+	// Play the generated stress levels and report how they ran, once the menu holds the volume and controller
+	// settings the levels read, but before the game's own levels start building.
+	StressTest::Run(sprite_renderer_, font_, &platform_, audio_manager_, &main_menu_, renderer_3d_, primitive_builder_);
+#endif
+	level_host_.Init(sprite_renderer_, font_, &platform_, &game_state_, &input_service_, audio_manager_, &main_menu_, renderer_3d_, primitive_builder_);
+	pause_menu_.Init(sprite_renderer_, font_, &platform_, &game_state_, input_manager_, audio_manager_, &level_host_, &main_menu_);
+	end_screen_.Init(sprite_renderer_, font_, &platform_, &game_state_, input_manager_, audio_manager_, &level_host_, &main_menu_);
 }
 
 void SceneApp::CleanUp()
 {
+	// Wait for any level being built, then free everything the levels loaded.
+	level_host_.CleanUp();
+
+	// Free the textures the screens loaded. The pause menu shares the main menu's.
+	splash_.CleanUp();
+	main_menu_.CleanUp();
+	end_screen_.CleanUp();
+
+	// Stop polling before the input manager is deleted.
+	input_service_.Stop();
+
 	// Delete all pointers and set as null.
 	delete input_manager_;
 	input_manager_ = NULL;
@@ -82,6 +113,8 @@ void SceneApp::CleanUp()
 
 	delete audio_manager_;
 	audio_manager_ = NULL;
+	MemoryTracker::Freed(MEMORY_AUDIO, audio_bytes_);
+	audio_bytes_ = 0;
 
 	delete world_;
 	world_ = NULL;
@@ -89,6 +122,23 @@ void SceneApp::CleanUp()
 
 bool SceneApp::Update(float frame_time)
 {
+	// Swap in the next level if one has been requested and is ready.
+	level_host_.Update();
+
+	// Poll input on the input thread while the level is being played. The simulation isn't running at this point,
+	// so it's safe to pause the input thread and let the menus use the input manager.
+	// gef's input manager isn't thread-safe, so it is only ever updated in one place at a time: by the input thread
+	// while it is polling, otherwise here. SetPolling returns once any poll in progress has finished. The screens only
+	// read the input manager from their Update, which is only called while polling is paused.
+	// The simulation for this frame hasn't started yet, so the game state is safe to read, and is what Render draws.
+	render_state_ = game_state_.GetGameState();
+	bool playing_level = render_state_ == State::LEVEL;
+	input_service_.SetPolling(playing_level);
+	if (!playing_level && input_manager_)
+	{
+		input_manager_->Update();
+	}
+
 	// Call an update function based on the current state.
 	switch (game_state_.GetGameState())
 	{
@@ -102,7 +152,7 @@ bool SceneApp::Update(float frame_time)
 		pause_menu_.Update(frame_time);
 		break;
 	case State::LEVEL:
-		level_.Update(frame_time);
+		level_host_.UpdateLevel(frame_time);
 		break;
 	case State::WIN:
 		end_screen_.Update(frame_time);
@@ -120,8 +170,10 @@ bool SceneApp::Update(float frame_time)
 
 void SceneApp::Render()
 {
-	// Call a render function based on the current state.
-	switch (game_state_.GetGameState())
+	// Call a render function based on the state at the start of the frame. If the level was being played, its
+	// simulation may still be running and may have changed the game state, e.g. to the end screen, which reads the
+	// level's score and time. Those screens are drawn from the next frame, once the simulation has been waited for.
+	switch (render_state_)
 	{
 	case State::SPLASH:
 		splash_.Render();
@@ -133,7 +185,7 @@ void SceneApp::Render()
 		pause_menu_.Render();
 		break;
 	case State::LEVEL:
-		level_.Render();
+		level_host_.RenderLevel();
 		break;
 	case State::WIN:
 		end_screen_.Render();
@@ -149,15 +201,24 @@ void SceneApp::Render()
 void SceneApp::InitSounds()
 {
 	// Load all of the audio files.
-	audio_manager_->LoadSample("audio/button_click.wav", platform_); // 0 - Button Click
-	audio_manager_->LoadSample("audio/spin_kick.wav", platform_); // 1 - Spinning Kick
-	audio_manager_->LoadSample("audio/bounce.wav", platform_); // 2 - Bounce
-	audio_manager_->LoadSample("audio/crate_break.wav", platform_); // 3 - Crate Break
-	audio_manager_->LoadSample("audio/enemy_hit.wav", platform_); // 4 - Enemy Hit
-	audio_manager_->LoadSample("audio/scream.wav", platform_); // 5 - Scream
-	audio_manager_->LoadSample("audio/footstep1.wav", platform_); // 6 - Footstep 1
-	audio_manager_->LoadSample("audio/footstep2.wav", platform_); // 7 - Footstep 2
-	audio_manager_->LoadSample("audio/coin.wav", platform_); // 8 - Coin Collected
-	audio_manager_->LoadSample("audio/clang.wav", platform_); // 9 - Metallic Clang
+	LoadSample("audio/button_click.wav"); // 0 - Button Click
+	LoadSample("audio/spin_kick.wav"); // 1 - Spinning Kick
+	LoadSample("audio/bounce.wav"); // 2 - Bounce
+	LoadSample("audio/crate_break.wav"); // 3 - Crate Break
+	LoadSample("audio/enemy_hit.wav"); // 4 - Enemy Hit
+	LoadSample("audio/scream.wav"); // 5 - Scream
+	LoadSample("audio/footstep1.wav"); // 6 - Footstep 1
+	LoadSample("audio/footstep2.wav"); // 7 - Footstep 2
+	LoadSample("audio/coin.wav"); // 8 - Coin Collected
+	LoadSample("audio/clang.wav"); // 9 - Metallic Clang
 }
 
+void SceneApp::LoadSample(const char* filename)
+{
+	// Load the sample and record its size against audio. The WAV is loaded whole, so the file size is what it holds on to.
+	audio_manager_->LoadSample(filename, platform_);
+
+	size_t bytes = AssetBlob::FileSize(filename);
+	audio_bytes_ += bytes;
+	MemoryTracker::Allocated(MEMORY_AUDIO, bytes);
+}
@@ -12,8 +12,9 @@
 #include "pause_menu.h"
 #include "splash_screen.h"
 #include "game_state.h"
-#include "level.h"
+#include "level_host.h"
 #include "end_screen.h"
+#include "input_service.h"
 
 
 // FRAMEWORK FORWARD DECLARATIONS
@@ -43,24 +44,35 @@ public:
 private:
 	// Function to load sounds.
 	void InitSounds();
+	void LoadSample(const char* filename);
 
 	// The main pointers needed for the game.
 	gef::SpriteRenderer* sprite_renderer_;
 	gef::Font* font_;
 	gef::InputManager* input_manager_;
 	gef::AudioManager* audio_manager_;
+
+	// Polls the input manager on its own thread while a level is being played.
+	InputService input_service_;
 	gef::Renderer3D* renderer_3d_;
 	PrimitiveBuilder* primitive_builder_;
 	b2World* world_;
 
+	// The memory held by the loaded samples.
+	size_t audio_bytes_;
+
 	// Holds the current game state.
 	GameState game_state_;
 
+	// The game state at the start of the frame, before the level's simulation was started. The simulation can change
+	// the game state while the frame is rendered, so Render uses this rather than reading the game state.
+	State render_state_;
+
 	// Objects for each of the states.
 	SplashScreen splash_;
 	MainMenu main_menu_;
 	PauseMenu pause_menu_;
-	Level level_;
+	LevelHost level_host_;
 	EndScreen end_screen_;
 };
 
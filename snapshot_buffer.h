@@ -0,0 +1,73 @@
+#ifndef _SNAPSHOT_BUFFER_H
+#define _SNAPSHOT_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+// Triple buffer for handing snapshots from one producer thread to one consumer thread without locking.
+// The producer fills the back buffer and publishes it, the consumer reads the newest published buffer.
+// Neither side ever waits for the other: a buffer being read is never written, and if the producer publishes
+// twice before the consumer looks, the older snapshot is simply dropped.
+template <class T>
+class SnapshotBuffer
+{
+public:
+	SnapshotBuffer()
+	{
+		Reset();
+	}
+
+	/// @brief Forget any published snapshots. Neither side may be using the buffer.
+	void Reset()
+	{
+		back_ = 0;
+		ready_.store(1);
+		front_ = 2;
+		has_front_ = false;
+	}
+
+	/// @brief The buffer for the producer to fill. Only valid until Publish is called.
+	T& back() { return buffers_[back_]; }
+
+	/// @brief Hand the back buffer to the consumer and take the spare one to fill next.
+	void Publish()
+	{
+		back_ = ready_.exchange(back_ | kFresh) & kIndexMask;
+	}
+
+	/// @brief The newest published snapshot. Stays valid and unchanged until Latest is called again.
+	/// @return NULL if nothing has been published since the last Reset.
+	const T* Latest()
+	{
+		if (ready_.load() & kFresh)
+		{
+			front_ = ready_.exchange(front_) & kIndexMask;
+			has_front_ = true;
+		}
+		return has_front_ ? &buffers_[front_] : NULL;
+	}
+
+	/// @brief Direct access to each of the buffers, e.g. to free what they hold. Neither side may be using the buffer.
+	T& buffer(int index) { return buffers_[index]; }
+
+	static const int kBufferCount = 3;
+
+private:
+	// the ready index has this bit set when it holds a snapshot the consumer hasn't taken yet
+	static const int kFresh = 4;
+	static const int kIndexMask = 3;
+
+	T buffers_[kBufferCount];
+
+	// only touched by the producer
+	int back_;
+
+	// swapped between the producer and consumer
+	std::atomic<int> ready_;
+
+	// only touched by the consumer
+	int front_;
+	bool has_front_;
+};
+
+#endif // _SNAPSHOT_BUFFER_H
@@ -0,0 +1,59 @@
+#ifndef _SPSC_QUEUE_H
+#define _SPSC_QUEUE_H
+
+#include <gef.h>
+#include <atomic>
+
+// Fixed size ring buffer for passing items from one producer thread to one consumer thread without locking.
+// The capacity must be a power of two. Push fails rather than blocking when the queue is full.
+template <class T, UInt32 CAPACITY>
+class SpscQueue
+{
+public:
+	SpscQueue() :
+		head_(0),
+		tail_(0)
+	{
+	}
+
+	/// @brief Add an item. Only call from the producer thread.
+	/// @return false if the queue is full, the item is not added.
+	bool Push(const T& item)
+	{
+		const UInt32 tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_.load(std::memory_order_acquire) == CAPACITY)
+			return false;
+
+		items_[tail & (CAPACITY - 1)] = item;
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// @brief The oldest item, without removing it. Only call from the consumer thread.
+	/// @return NULL if the queue is empty.
+	const T* Front() const
+	{
+		const UInt32 head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire))
+			return NULL;
+
+		return &items_[head & (CAPACITY - 1)];
+	}
+
+	/// @brief Remove the oldest item. Only call from the consumer thread, after Front has returned an item.
+	void Pop()
+	{
+		head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+private:
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+	T items_[CAPACITY];
+
+	// the counters only ever increase and wrap round, the index into items_ is taken from the low bits
+	std::atomic<UInt32> head_;
+	std::atomic<UInt32> tail_;
+};
+
+#endif // _SPSC_QUEUE_H
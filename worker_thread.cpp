@@ -0,0 +1,62 @@
+#include "worker_thread.h"
+
+WorkerThread::WorkerThread() :
+	has_job_(false),
+	quit_(false)
+{
+	thread_ = std::thread(&WorkerThread::Run, this);
+}
+
+WorkerThread::~WorkerThread()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		job_changed_.wait(lock, [this] { return !has_job_; });
+		quit_ = true;
+	}
+	job_changed_.notify_all();
+	thread_.join();
+}
+
+void WorkerThread::Kick(const std::function<void()>& job)
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		job_changed_.wait(lock, [this] { return !has_job_; });
+		job_ = job;
+		has_job_ = true;
+	}
+	job_changed_.notify_all();
+}
+
+void WorkerThread::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	job_changed_.wait(lock, [this] { return !has_job_; });
+}
+
+bool WorkerThread::busy()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return has_job_;
+}
+
+void WorkerThread::Run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;)
+	{
+		job_changed_.wait(lock, [this] { return has_job_ || quit_; });
+		if (quit_)
+			break;
+
+		// run the job without the lock held, so the other thread can check on it
+		lock.unlock();
+		job_();
+		lock.lock();
+
+		job_ = std::function<void()>();
+		has_job_ = false;
+		job_changed_.notify_all();
+	}
+}
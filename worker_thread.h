@@ -0,0 +1,38 @@
+#ifndef _WORKER_THREAD_H
+#define _WORKER_THREAD_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// A thread that is kept alive and runs one job at a time, so work can be handed off every frame without
+// the cost of starting a thread each time.
+class WorkerThread
+{
+public:
+	WorkerThread();
+	~WorkerThread();
+
+	/// @brief Start running a job on the thread. Waits for the previous job to finish first.
+	void Kick(const std::function<void()>& job);
+
+	/// @brief Wait for the current job, if there is one, to finish.
+	void Wait();
+
+	/// @brief Whether a job has been kicked and hasn't finished.
+	bool busy();
+
+private:
+	void Run();
+
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable job_changed_;
+
+	std::function<void()> job_;
+	bool has_job_;
+	bool quit_;
+};
+
+#endif // _WORKER_THREAD_H